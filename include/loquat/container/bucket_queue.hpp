@@ -0,0 +1,114 @@
+#pragma once
+#include <vector>
+#include <utility>
+#include <type_traits>
+#include <cassert>
+
+namespace loquat {
+
+/**
+ * @brief 幅の限られた単調な整数キーを持つ優先度付きキュー (Dial のバケット法)。
+ * @tparam Key   キーの型。
+ * @tparam Value キーに付随する値の型。
+ *
+ * 追加するキーは最後に取り出したキー (初期値は <tt>Key()</tt>) 以上、
+ * かつそのキーとの差が max_span 以下でなければなりません。
+ */
+template <typename Key, typename Value>
+class bucket_queue {
+
+	static_assert(
+		std::is_integral<Key>::value,
+		"bucket_queue requires an integral key type");
+
+public:
+	using key_type = Key;
+	using mapped_type = Value;
+	using value_type = std::pair<key_type, mapped_type>;
+
+
+private:
+	std::vector<std::vector<mapped_type>> m_buckets;
+	key_type m_current;
+	size_t m_cursor;
+	size_t m_size;
+
+
+	void advance(){
+		const size_t m = m_buckets.size();
+		while(m_buckets[m_cursor].empty()){
+			if(++m_cursor == m){ m_cursor = 0; }
+			++m_current;
+		}
+	}
+
+
+public:
+	bucket_queue()
+		: m_buckets(1)
+		, m_current()
+		, m_cursor(0)
+		, m_size(0)
+	{ }
+
+	explicit bucket_queue(size_t max_span)
+		: m_buckets(max_span + 1)
+		, m_current()
+		, m_cursor(0)
+		, m_size(0)
+	{ }
+
+
+	bool empty() const {
+		return m_size == 0;
+	}
+
+	size_t size() const {
+		return m_size;
+	}
+
+	size_t max_span() const {
+		return m_buckets.size() - 1;
+	}
+
+
+	value_type top(){
+		assert(m_size > 0);
+		advance();
+		return value_type(m_current, m_buckets[m_cursor].back());
+	}
+
+	void push(const key_type& key, const mapped_type& value){
+		assert(m_current <= key);
+		const auto d = static_cast<size_t>(key - m_current);
+		assert(d < m_buckets.size());
+		const size_t m = m_buckets.size();
+		const size_t i = (m_cursor + d < m) ? (m_cursor + d) : (m_cursor + d - m);
+		m_buckets[i].push_back(value);
+		++m_size;
+	}
+
+	void pop(){
+		assert(m_size > 0);
+		advance();
+		m_buckets[m_cursor].pop_back();
+		--m_size;
+	}
+
+	/**
+	 * @brief すべての要素を取り除き、最後に取り出したキーを初期値に戻します。
+	 *
+	 * 要素が残っている場合は O(max_span) 時間かかります。
+	 */
+	void clear(){
+		if(m_size > 0){
+			for(auto& bucket : m_buckets){ bucket.clear(); }
+		}
+		m_current = key_type();
+		m_cursor = 0;
+		m_size = 0;
+	}
+
+};
+
+}
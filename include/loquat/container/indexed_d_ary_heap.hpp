@@ -0,0 +1,153 @@
+#pragma once
+#include <vector>
+#include <limits>
+#include <utility>
+#include <functional>
+#include <cassert>
+
+namespace loquat {
+
+/**
+ * @brief 添字付きの D 分ヒープ。
+ * @tparam Key        キーの型。
+ * @tparam D          各ノードが持つ子の数。
+ * @tparam Comparator キーの比較関数。先頭に来るべき要素で真を返す。
+ *
+ * 要素は [0, n) の添字で識別され、各添字は高々1つだけヒープに含まれます。
+ * 既に含まれている添字に対して push を行うとキーが更新されます。
+ */
+template <typename Key, size_t D = 4, typename Comparator = std::less<Key>>
+class indexed_d_ary_heap {
+
+	static_assert(D >= 2, "indexed_d_ary_heap requires D >= 2");
+
+public:
+	using key_type = Key;
+	using index_type = size_t;
+	using value_type = std::pair<key_type, index_type>;
+	using comparator_type = Comparator;
+
+
+private:
+	static const size_t npos = std::numeric_limits<size_t>::max();
+
+	std::vector<value_type> m_heap;
+	std::vector<size_t> m_positions;
+	comparator_type m_comparator;
+
+
+	void sift_up(size_t pos){
+		value_type x = std::move(m_heap[pos]);
+		while(pos > 0){
+			const size_t parent = (pos - 1) / D;
+			if(!m_comparator(x.first, m_heap[parent].first)){ break; }
+			m_heap[pos] = std::move(m_heap[parent]);
+			m_positions[m_heap[pos].second] = pos;
+			pos = parent;
+		}
+		m_positions[x.second] = pos;
+		m_heap[pos] = std::move(x);
+	}
+
+	void sift_down(size_t pos){
+		const size_t n = m_heap.size();
+		value_type x = std::move(m_heap[pos]);
+		while(true){
+			const size_t first = pos * D + 1;
+			if(first >= n){ break; }
+			const size_t last = (first + D < n) ? (first + D) : n;
+			size_t best = first;
+			for(size_t c = first + 1; c < last; ++c){
+				if(m_comparator(m_heap[c].first, m_heap[best].first)){ best = c; }
+			}
+			if(!m_comparator(m_heap[best].first, x.first)){ break; }
+			m_heap[pos] = std::move(m_heap[best]);
+			m_positions[m_heap[pos].second] = pos;
+			pos = best;
+		}
+		m_positions[x.second] = pos;
+		m_heap[pos] = std::move(x);
+	}
+
+
+public:
+	indexed_d_ary_heap()
+		: m_heap()
+		, m_positions()
+		, m_comparator()
+	{ }
+
+	explicit indexed_d_ary_heap(
+		size_t n,
+		const comparator_type& comparator = comparator_type())
+		: m_heap()
+		, m_positions(n, std::numeric_limits<size_t>::max())
+		, m_comparator(comparator)
+	{ }
+
+
+	bool empty() const {
+		return m_heap.empty();
+	}
+
+	size_t size() const {
+		return m_heap.size();
+	}
+
+	size_t capacity() const {
+		return m_positions.size();
+	}
+
+
+	bool contains(index_type i) const {
+		return m_positions[i] != npos;
+	}
+
+	const key_type& key(index_type i) const {
+		assert(contains(i));
+		return m_heap[m_positions[i]].first;
+	}
+
+	const value_type& top() const {
+		assert(!m_heap.empty());
+		return m_heap[0];
+	}
+
+
+	void push(const key_type& key, index_type i){
+		if(m_positions[i] == npos){
+			m_positions[i] = m_heap.size();
+			m_heap.emplace_back(key, i);
+			sift_up(m_heap.size() - 1);
+			return;
+		}
+		const size_t pos = m_positions[i];
+		const bool up = m_comparator(key, m_heap[pos].first);
+		m_heap[pos].first = key;
+		if(up){
+			sift_up(pos);
+		}else{
+			sift_down(pos);
+		}
+	}
+
+	void pop(){
+		assert(!m_heap.empty());
+		m_positions[m_heap[0].second] = npos;
+		if(m_heap.size() > 1){
+			m_heap[0] = std::move(m_heap.back());
+			m_heap.pop_back();
+			sift_down(0);
+		}else{
+			m_heap.pop_back();
+		}
+	}
+
+	void clear(){
+		for(const auto& x : m_heap){ m_positions[x.second] = npos; }
+		m_heap.clear();
+	}
+
+};
+
+}
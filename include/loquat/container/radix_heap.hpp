@@ -0,0 +1,117 @@
+#pragma once
+#include <vector>
+#include <limits>
+#include <utility>
+#include <type_traits>
+#include <cassert>
+#include "loquat/math/bitmanip.hpp"
+
+namespace loquat {
+
+/**
+ * @brief 単調な整数キーを持つ優先度付きキュー。
+ * @tparam Key   キーの型。非負の値のみを扱う整数型。
+ * @tparam Value キーに付随する値の型。
+ *
+ * 取り出されるキーが単調非減少であり、かつ追加するキーが最後に取り出したキー以上である場合にのみ使用できます。
+ */
+template <typename Key, typename Value>
+class radix_heap {
+
+	static_assert(
+		std::is_integral<Key>::value,
+		"radix_heap requires an integral key type");
+
+public:
+	using key_type = Key;
+	using mapped_type = Value;
+	using value_type = std::pair<key_type, mapped_type>;
+
+
+private:
+	using unsigned_type = typename std::make_unsigned<key_type>::type;
+
+	static const size_t num_buckets =
+		std::numeric_limits<unsigned_type>::digits + 1;
+
+	std::vector<std::vector<value_type>> m_buckets;
+	unsigned_type m_last;
+	size_t m_size;
+
+
+	static size_t bucket_index(unsigned_type x){
+		if(x == 0u){ return 0; }
+		const size_t width = (sizeof(unsigned_type) <= sizeof(unsigned int))
+			? std::numeric_limits<unsigned int>::digits
+			: std::numeric_limits<unsigned long long>::digits;
+		return width - bitmanip::clz(x);
+	}
+
+	void pull(){
+		if(!m_buckets[0].empty()){ return; }
+		size_t i = 1;
+		while(m_buckets[i].empty()){ ++i; }
+		auto& bucket = m_buckets[i];
+		unsigned_type last = static_cast<unsigned_type>(bucket[0].first);
+		for(const auto& x : bucket){
+			const auto k = static_cast<unsigned_type>(x.first);
+			if(k < last){ last = k; }
+		}
+		m_last = last;
+		for(auto& x : bucket){
+			const auto k = static_cast<unsigned_type>(x.first);
+			m_buckets[bucket_index(k ^ m_last)].push_back(std::move(x));
+		}
+		bucket.clear();
+	}
+
+
+public:
+	radix_heap()
+		: m_buckets(num_buckets)
+		, m_last(0)
+		, m_size(0)
+	{ }
+
+
+	bool empty() const {
+		return m_size == 0;
+	}
+
+	size_t size() const {
+		return m_size;
+	}
+
+
+	const value_type& top(){
+		assert(m_size > 0);
+		pull();
+		return m_buckets[0].back();
+	}
+
+	void push(const key_type& key, const mapped_type& value){
+		const auto k = static_cast<unsigned_type>(key);
+		assert(m_last <= k);
+		m_buckets[bucket_index(k ^ m_last)].emplace_back(key, value);
+		++m_size;
+	}
+
+	void pop(){
+		assert(m_size > 0);
+		pull();
+		m_buckets[0].pop_back();
+		--m_size;
+	}
+
+	/**
+	 * @brief すべての要素を取り除き、最後に取り出したキーを初期値に戻します。
+	 */
+	void clear(){
+		for(auto& bucket : m_buckets){ bucket.clear(); }
+		m_last = 0;
+		m_size = 0;
+	}
+
+};
+
+}
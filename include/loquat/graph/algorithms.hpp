@@ -19,5 +19,19 @@ adjacency_list<EdgeType> filter(
 	return result;
 }
 
+template <typename EdgeType>
+adjacency_list<EdgeType> transpose(const adjacency_list<EdgeType>& graph){
+	const size_t n = graph.size();
+	adjacency_list<EdgeType> result(n);
+	for(vertex_t u = 0; u < n; ++u){
+		for(const auto& e : graph[u]){
+			auto f = e;
+			f.to = u;
+			result.add_edge(e.to, f);
+		}
+	}
+	return result;
+}
+
 }
 
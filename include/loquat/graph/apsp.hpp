@@ -0,0 +1,30 @@
+#pragma once
+#include "loquat/graph/adjacency_list.hpp"
+#include "loquat/graph/apsp_johnson.hpp"
+#include "loquat/graph/apsp_floyd_warshall.hpp"
+#include "loquat/math/matrix.hpp"
+
+namespace loquat {
+
+/**
+ * @brief 全点対最短路。
+ *
+ * 辺数 m と頂点数 n について m log n が n^2 以上となる密なグラフでは
+ * Floyd-Warshall 法を、それ以外では Johnson 法を使用します。
+ */
+template <typename EdgeType>
+matrix<typename EdgeType::weight_type>
+apsp(const adjacency_list<EdgeType>& graph){
+	const auto n = graph.size();
+	size_t m = 0;
+	for(vertex_t u = 0; u < n; ++u){ m += graph[u].size(); }
+	size_t log_n = 1;
+	while((size_t(1) << log_n) < n){ ++log_n; }
+	if(m * log_n >= n * n){
+		return apsp_floyd_warshall(graph);
+	}else{
+		return apsp_johnson(graph);
+	}
+}
+
+}
@@ -0,0 +1,107 @@
+#pragma once
+#include <vector>
+#include <algorithm>
+#include "loquat/graph/adjacency_list.hpp"
+#include "loquat/graph/sssp_spfa.hpp"
+#include "loquat/math/matrix.hpp"
+#include "loquat/math/infinity.hpp"
+#include "loquat/misc/exceptions.hpp"
+
+namespace loquat {
+
+namespace detail {
+
+// returns false if d(k, k) of the diagonal block is negative before k is used as an intermediate
+template <typename T>
+bool floyd_warshall_block(
+	matrix<T>& d,
+	size_t ib, size_t jb, size_t kb,
+	size_t block_size)
+{
+	const auto n = d.rows();
+	const auto i_last = std::min(ib + block_size, n);
+	const auto j_last = std::min(jb + block_size, n);
+	const auto k_last = std::min(kb + block_size, n);
+	const bool diagonal = (ib == kb && jb == kb);
+	for(size_t k = kb; k < k_last; ++k){
+		if(diagonal && d(k, k) < T()){ return false; }
+		for(size_t i = ib; i < i_last; ++i){
+			const auto dik = d(i, k);
+			if(is_positive_infinity(dik)){ continue; }
+			for(size_t j = jb; j < j_last; ++j){
+				const auto dkj = d(k, j);
+				if(is_positive_infinity(dkj)){ continue; }
+				if(dik + dkj < d(i, j)){ d(i, j) = dik + dkj; }
+			}
+		}
+	}
+	return true;
+}
+
+}
+
+
+/**
+ * @brief 距離行列に対する Floyd-Warshall 法。
+ * @param d          隣接行列。辺が存在しない要素は正の無限大とします。
+ * @param block_size キャッシュ効率のために一度に処理する部分行列の大きさ。
+ *
+ * 行列をブロックに分割し、対角ブロック・同じ行と列のブロック・残りのブロックの順に更新します。
+ * 負閉路が存在する場合は、経由点として使用する前の対角要素が負になった時点で
+ * loquat::negative_cycle_error を送出します。行列からは閉路を復元できないため cycle() は空です。
+ */
+template <typename T>
+void floyd_warshall(matrix<T>& d, size_t block_size = 64){
+	const auto n = d.rows();
+	if(block_size == 0){ block_size = 1; }
+	for(size_t kb = 0; kb < n; kb += block_size){
+		if(!detail::floyd_warshall_block(d, kb, kb, kb, block_size)){
+			throw negative_cycle_error(
+				"graph has a negative cycle", std::vector<size_t>());
+		}
+		for(size_t jb = 0; jb < n; jb += block_size){
+			if(jb == kb){ continue; }
+			detail::floyd_warshall_block(d, kb, jb, kb, block_size);
+		}
+		for(size_t ib = 0; ib < n; ib += block_size){
+			if(ib == kb){ continue; }
+			detail::floyd_warshall_block(d, ib, kb, kb, block_size);
+		}
+		for(size_t ib = 0; ib < n; ib += block_size){
+			if(ib == kb){ continue; }
+			for(size_t jb = 0; jb < n; jb += block_size){
+				if(jb == kb){ continue; }
+				detail::floyd_warshall_block(d, ib, jb, kb, block_size);
+			}
+		}
+	}
+}
+
+/**
+ * @brief Floyd-Warshall 法による全点対最短路。
+ *
+ * 負閉路が存在する場合は、その閉路を持つ loquat::negative_cycle_error を送出します。
+ */
+template <typename EdgeType>
+matrix<typename EdgeType::weight_type>
+apsp_floyd_warshall(const adjacency_list<EdgeType>& graph){
+	using weight_type = typename EdgeType::weight_type;
+	const auto inf = positive_infinity<weight_type>();
+	const auto n = graph.size();
+	matrix<weight_type> d(n, n, inf);
+	for(vertex_t u = 0; u < n; ++u){
+		d(u, u) = weight_type();
+		for(const auto& e : graph[u]){
+			if(e.weight < d(u, e.to)){ d(u, e.to) = e.weight; }
+		}
+	}
+	try{
+		floyd_warshall(d);
+	}catch(const negative_cycle_error&){
+		throw negative_cycle_error(
+			"graph has a negative cycle", find_negative_cycle(graph));
+	}
+	return d;
+}
+
+}
@@ -0,0 +1,129 @@
+#pragma once
+#include <vector>
+#include <deque>
+#include <utility>
+#include "loquat/graph/adjacency_list.hpp"
+#include "loquat/graph/sssp_queue_policy.hpp"
+#include "loquat/graph/sssp_spfa.hpp"
+#include "loquat/math/matrix.hpp"
+#include "loquat/math/infinity.hpp"
+#include "loquat/misc/exceptions.hpp"
+#include "loquat/misc/parallel.hpp"
+
+namespace loquat {
+
+namespace detail {
+
+// runs Dijkstra from each source in [first, last) and fills the rows of result,
+// resetting only the vertices reached by the previous source
+template <typename EdgeType>
+void johnson_rows(
+	const adjacency_list<EdgeType>& graph,
+	const std::vector<typename EdgeType::weight_type>& potentials,
+	matrix<typename EdgeType::weight_type>& result,
+	vertex_t first,
+	vertex_t last)
+{
+	using weight_type = typename EdgeType::weight_type;
+	using policy_type = sssp_queue_policy::automatic;
+	const auto inf = positive_infinity<weight_type>();
+	const auto n = graph.size();
+	std::vector<weight_type> dist(n, inf);
+	std::vector<vertex_t> touched;
+	auto pq = policy_type::make_queue<weight_type>(graph);
+	for(vertex_t s = first; s < last; ++s){
+		for(const auto v : touched){ dist[v] = inf; }
+		touched.clear();
+		pq.clear();
+		dist[s] = weight_type();
+		touched.push_back(s);
+		pq.push(weight_type(), s);
+		while(!pq.empty()){
+			const auto top = pq.top();
+			const auto x = top.first;
+			const auto u = top.second;
+			pq.pop();
+			if(dist[u] < x){ continue; }
+			for(const auto& e : graph[u]){
+				const auto v = e.to;
+				const auto y = x + e.weight;
+				if(!(y < dist[v])){ continue; }
+				if(is_positive_infinity(dist[v])){ touched.push_back(v); }
+				dist[v] = y;
+				pq.push(y, v);
+			}
+		}
+		for(const auto t : touched){
+			result(s, t) = dist[t] - potentials[s] + potentials[t];
+		}
+	}
+}
+
+}
+
+
+/**
+ * @brief Johnson 法による全点対最短路。
+ * @param num_threads Dijkstra 法の実行に使用するスレッド数の上限。
+ *
+ * 負の重みを持つ辺が存在する場合、すべての頂点を始点とする Bellman-Ford 法 (SPFA) で
+ * ポテンシャルを求めて重みを非負に変換した後、各頂点から Dijkstra 法を実行します。
+ * 始点の集合を連続したブロックに分けて各スレッドに割り当て、スレッドごとに距離の配列とキューを
+ * 使い回します。各スレッドは担当する始点の行のみに書き込みます。
+ * num_threads が 2 以上の場合、ポテンシャルはラウンドごとに並列に緩和する SPFA で求めます。
+ * 負閉路が存在する場合は loquat::negative_cycle_error を送出します。
+ */
+template <typename EdgeType>
+matrix<typename EdgeType::weight_type>
+apsp_johnson(const adjacency_list<EdgeType>& graph, size_t num_threads){
+	using weight_type = typename EdgeType::weight_type;
+	const auto inf = positive_infinity<weight_type>();
+	const auto n = graph.size();
+	std::vector<weight_type> potentials(n, weight_type());
+	bool has_negative_edge = false;
+	for(vertex_t u = 0; u < n; ++u){
+		for(const auto& e : graph[u]){
+			if(e.weight < weight_type()){ has_negative_edge = true; }
+		}
+	}
+	adjacency_list<EdgeType> reduced;
+	if(has_negative_edge){
+		std::vector<vertex_t> parents(n, n);
+		std::vector<vertex_t> cycle;
+		if(num_threads <= 1){
+			std::deque<vertex_t> q;
+			for(vertex_t v = 0; v < n; ++v){ q.push_back(v); }
+			cycle = detail::spfa_impl(graph, potentials, parents, q);
+		}else{
+			std::vector<vertex_t> frontier(n);
+			for(vertex_t v = 0; v < n; ++v){ frontier[v] = v; }
+			cycle = detail::spfa_rounds_impl(
+				graph, potentials, parents, std::move(frontier), num_threads);
+		}
+		if(!cycle.empty()){
+			throw negative_cycle_error(
+				"graph has a negative cycle", std::move(cycle));
+		}
+		reduced = graph;
+		for(vertex_t u = 0; u < n; ++u){
+			for(auto& e : reduced[u]){
+				e.weight = e.weight + potentials[u] - potentials[e.to];
+			}
+		}
+	}
+	const auto& g = has_negative_edge ? reduced : graph;
+	matrix<weight_type> result(n, n, inf);
+	parallel_for_blocks(num_threads, n, 1,
+		[&](size_t, size_t first, size_t last){
+			detail::johnson_rows(g, potentials, result, first, last);
+		});
+	return result;
+}
+
+template <typename EdgeType>
+matrix<typename EdgeType::weight_type>
+apsp_johnson(const adjacency_list<EdgeType>& graph){
+	return apsp_johnson(graph, hardware_concurrency());
+}
+
+}
@@ -0,0 +1,89 @@
+#pragma once
+#include <vector>
+#include <algorithm>
+#include "loquat/math/matrix.hpp"
+#include "loquat/math/infinity.hpp"
+#include "loquat/misc/exceptions.hpp"
+
+namespace loquat {
+
+/**
+ * @brief 割当問題の解。
+ */
+template <typename T>
+struct assignment_result {
+	/// 割り当てたコストの合計
+	T cost;
+	/// 各行に割り当てた列
+	std::vector<size_t> assignment;
+};
+
+
+/**
+ * @brief Hungarian 法による割当問題。
+ * @param costs 行 i を列 j に割り当てるコストを要素 (i, j) に持つ行列。行数は列数以下である必要があります。
+ *
+ * すべての行を相異なる列に割り当てる方法のうち、コストの合計が最小のものを求めます。
+ * 計算量は O(N^2 M) です。
+ */
+template <typename T>
+assignment_result<T> assignment_hungarian(const matrix<T>& costs){
+	const auto inf = positive_infinity<T>();
+	const size_t n = costs.rows(), m = costs.columns();
+	if(n > m){
+		throw no_solution_error("the number of rows exceeds the number of columns");
+	}
+	// rows and columns are 1-indexed, column 0 is a sentinel
+	std::vector<T> u(n + 1), v(m + 1), min_slack(m + 1);
+	std::vector<size_t> row_of(m + 1, 0), way(m + 1, 0);
+	std::vector<bool> used(m + 1);
+	for(size_t i = 1; i <= n; ++i){
+		row_of[0] = i;
+		size_t j0 = 0;
+		std::fill(min_slack.begin(), min_slack.end(), inf);
+		std::fill(used.begin(), used.end(), false);
+		do {
+			used[j0] = true;
+			const auto i0 = row_of[j0];
+			T delta = inf;
+			size_t j1 = 0;
+			for(size_t j = 1; j <= m; ++j){
+				if(used[j]){ continue; }
+				const auto cur = costs(i0 - 1, j - 1) - u[i0] - v[j];
+				if(cur < min_slack[j]){
+					min_slack[j] = cur;
+					way[j] = j0;
+				}
+				if(min_slack[j] < delta){
+					delta = min_slack[j];
+					j1 = j;
+				}
+			}
+			for(size_t j = 0; j <= m; ++j){
+				if(used[j]){
+					u[row_of[j]] += delta;
+					v[j] -= delta;
+				}else{
+					min_slack[j] -= delta;
+				}
+			}
+			j0 = j1;
+		} while(row_of[j0] != 0);
+		do {
+			const auto j1 = way[j0];
+			row_of[j0] = row_of[j1];
+			j0 = j1;
+		} while(j0 != 0);
+	}
+	assignment_result<T> result;
+	result.cost = T();
+	result.assignment.assign(n, m);
+	for(size_t j = 1; j <= m; ++j){
+		if(row_of[j] == 0){ continue; }
+		result.assignment[row_of[j] - 1] = j - 1;
+		result.cost += costs(row_of[j] - 1, j - 1);
+	}
+	return result;
+}
+
+}
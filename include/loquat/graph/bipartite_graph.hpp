@@ -0,0 +1,94 @@
+#pragma once
+#include <vector>
+#include <utility>
+#include "loquat/graph/adjacency_list.hpp"
+
+namespace loquat {
+
+/**
+ * @brief 左側の頂点から右側の頂点への辺のみを持つ二部グラフ。
+ *
+ * 辺は左側の頂点ごとに CSR 形式で連続した領域に格納されます。
+ */
+class bipartite_graph {
+
+private:
+	size_t m_num_left;
+	size_t m_num_right;
+	std::vector<size_t> m_offsets;
+	std::vector<vertex_t> m_targets;
+
+public:
+	bipartite_graph()
+		: m_num_left(0)
+		, m_num_right(0)
+		, m_offsets(1, 0)
+		, m_targets()
+	{ }
+
+	/**
+	 * @param edges (左側の頂点, 右側の頂点) の組のリスト。
+	 */
+	bipartite_graph(
+		size_t num_left,
+		size_t num_right,
+		const std::vector<std::pair<vertex_t, vertex_t>>& edges)
+		: m_num_left(num_left)
+		, m_num_right(num_right)
+		, m_offsets(num_left + 1, 0)
+		, m_targets(edges.size())
+	{
+		for(const auto& e : edges){ ++m_offsets[e.first + 1]; }
+		for(size_t u = 0; u < num_left; ++u){ m_offsets[u + 1] += m_offsets[u]; }
+		std::vector<size_t> heads(m_offsets.begin(), m_offsets.end() - 1);
+		for(const auto& e : edges){ m_targets[heads[e.first]++] = e.second; }
+	}
+
+	/**
+	 * @param graph 頂点 u から右側の頂点 e.to への辺を持つグラフ。graph.size() が左側の頂点数となります。
+	 */
+	template <typename EdgeType>
+	bipartite_graph(const adjacency_list<EdgeType>& graph, size_t num_right)
+		: m_num_left(graph.size())
+		, m_num_right(num_right)
+		, m_offsets(graph.size() + 1, 0)
+		, m_targets()
+	{
+		for(vertex_t u = 0; u < m_num_left; ++u){
+			m_offsets[u + 1] = m_offsets[u] + graph[u].size();
+		}
+		m_targets.reserve(m_offsets.back());
+		for(vertex_t u = 0; u < m_num_left; ++u){
+			for(const auto& e : graph[u]){ m_targets.push_back(e.to); }
+		}
+	}
+
+
+	size_t num_left() const {
+		return m_num_left;
+	}
+
+	size_t num_right() const {
+		return m_num_right;
+	}
+
+	size_t num_edges() const {
+		return m_targets.size();
+	}
+
+
+	size_t degree(vertex_t u) const {
+		return m_offsets[u + 1] - m_offsets[u];
+	}
+
+	const vertex_t *neighbors_begin(vertex_t u) const {
+		return m_targets.data() + m_offsets[u];
+	}
+
+	const vertex_t *neighbors_end(vertex_t u) const {
+		return m_targets.data() + m_offsets[u + 1];
+	}
+
+};
+
+}
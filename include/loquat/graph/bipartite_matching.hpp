@@ -0,0 +1,113 @@
+#pragma once
+#include <vector>
+#include <limits>
+#include "loquat/graph/bipartite_graph.hpp"
+
+namespace loquat {
+
+/**
+ * @brief 二部グラフの最大マッチング。
+ */
+struct bipartite_matching_result {
+	/// マッチングの辺数
+	size_t size;
+	/// 左側の頂点に対応する右側の頂点 (存在しない場合は右側の頂点数)
+	std::vector<vertex_t> left_to_right;
+	/// 右側の頂点に対応する左側の頂点 (存在しない場合は左側の頂点数)
+	std::vector<vertex_t> right_to_left;
+};
+
+
+/**
+ * @brief Hopcroft-Karp 法による二部グラフの最大マッチング。
+ *
+ * 計算量は O(E sqrt(V)) です。
+ */
+inline bipartite_matching_result
+bipartite_matching_hopcroft_karp(const bipartite_graph& graph){
+	const auto inf = std::numeric_limits<size_t>::max();
+	const auto n = graph.num_left();
+	const auto m = graph.num_right();
+	bipartite_matching_result result;
+	result.size = 0;
+	auto& match_left = result.left_to_right;
+	auto& match_right = result.right_to_left;
+	match_left.assign(n, m);
+	match_right.assign(m, n);
+
+	std::vector<size_t> dist(n);
+	std::vector<vertex_t> queue(n);
+	std::vector<const vertex_t *> iterators(n);
+	std::vector<vertex_t> stack;
+	stack.reserve(n);
+	while(true){
+		// layer the left vertices by alternating path length
+		size_t tail = 0;
+		for(vertex_t u = 0; u < n; ++u){
+			if(match_left[u] == m){
+				dist[u] = 0;
+				queue[tail++] = u;
+			}else{
+				dist[u] = inf;
+			}
+		}
+		size_t limit = inf;
+		for(size_t head = 0; head < tail; ++head){
+			const auto u = queue[head];
+			if(dist[u] >= limit){ break; }
+			for(auto it = graph.neighbors_begin(u); it != graph.neighbors_end(u); ++it){
+				const auto w = match_right[*it];
+				if(w == n){
+					limit = dist[u];
+				}else if(dist[w] == inf){
+					dist[w] = dist[u] + 1;
+					queue[tail++] = w;
+				}
+			}
+		}
+		if(limit == inf){ break; }
+
+		// find a maximal set of vertex disjoint shortest augmenting paths
+		for(vertex_t u = 0; u < n; ++u){
+			iterators[u] = graph.neighbors_begin(u);
+		}
+		for(vertex_t r = 0; r < n; ++r){
+			if(match_left[r] != m || dist[r] != 0){ continue; }
+			stack.clear();
+			stack.push_back(r);
+			while(!stack.empty()){
+				const auto u = stack.back();
+				auto& it = iterators[u];
+				if(it == graph.neighbors_end(u)){
+					dist[u] = inf;
+					stack.pop_back();
+					if(!stack.empty()){ ++iterators[stack.back()]; }
+					continue;
+				}
+				const auto w = match_right[*it];
+				if(w == n){
+					if(dist[u] != limit){
+						++it;
+						continue;
+					}
+					for(const auto x : stack){
+						const auto v = *iterators[x];
+						match_left[x] = v;
+						match_right[v] = x;
+						dist[x] = inf;
+					}
+					++result.size;
+					break;
+				}
+				if(dist[w] != inf && dist[w] == dist[u] + 1){
+					stack.push_back(w);
+				}else{
+					++it;
+				}
+			}
+		}
+	}
+	return result;
+}
+
+}
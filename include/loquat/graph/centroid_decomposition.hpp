@@ -0,0 +1,227 @@
+#pragma once
+#include <vector>
+#include <utility>
+#include "loquat/graph/adjacency_list.hpp"
+
+namespace loquat {
+
+/**
+ * @brief 木の重心分解。
+ *
+ * 重心木の親と深さ (レベル) に加えて、次の 2 種類の距離を辺の本数で保持します。
+ * - 各頂点からレベル k の祖先重心までの距離。レベルごとに長さ n の配列として連続に並びます。
+ * - 各重心が担当する成分の頂点とその重心からの距離。重心自身が先頭に来て、その後に分岐ごとに
+ *   BFS 順で並びます。分岐とは、重心を取り除いたときに分かれる部分木のことです。
+ * 構築は再帰を使わずに O(n log n) で行います。
+ */
+class centroid_decomposition {
+
+public:
+	struct entry {
+		vertex_t vertex;
+		size_t distance;
+	};
+
+	using const_iterator = std::vector<entry>::const_iterator;
+
+
+private:
+	std::vector<vertex_t> m_parents;
+	std::vector<size_t> m_levels;
+	// centroids in decomposition order and the inverse permutation
+	std::vector<vertex_t> m_order;
+	std::vector<size_t> m_ranks;
+	std::vector<size_t> m_distances;
+	std::vector<entry> m_entries;
+	std::vector<size_t> m_component_offsets;
+	std::vector<size_t> m_branch_bounds;
+	std::vector<size_t> m_branch_offsets;
+
+
+public:
+	centroid_decomposition()
+		: m_parents()
+		, m_levels()
+		, m_order()
+		, m_ranks()
+		, m_distances()
+		, m_entries()
+		, m_component_offsets(1, 0)
+		, m_branch_bounds()
+		, m_branch_offsets(1, 0)
+	{ }
+
+	template <typename EdgeType>
+	explicit centroid_decomposition(const adjacency_list<EdgeType>& graph)
+		: m_parents(graph.size(), graph.size())
+		, m_levels(graph.size(), 0)
+		, m_order()
+		, m_ranks(graph.size())
+		, m_distances()
+		, m_entries()
+		, m_component_offsets()
+		, m_branch_bounds()
+		, m_branch_offsets()
+	{
+		const auto n = graph.size();
+		m_order.reserve(n);
+		m_component_offsets.reserve(n + 1);
+		m_branch_offsets.reserve(n + 1);
+		std::vector<bool> removed(n, false);
+		std::vector<vertex_t> bfs_parents(n, n), queue;
+		std::vector<size_t> sizes(n);
+		queue.reserve(n);
+		// pending components in BFS order of the centroid tree as (any vertex, parent centroid)
+		std::vector<std::pair<vertex_t, vertex_t>> pending;
+		if(n > 0){ pending.emplace_back(0, n); }
+		for(size_t head = 0; head < pending.size(); ++head){
+			const auto r = pending[head].first;
+			const auto p = pending[head].second;
+			queue.assign(1, r);
+			bfs_parents[r] = n;
+			for(size_t i = 0; i < queue.size(); ++i){
+				const auto u = queue[i];
+				for(const auto& e : graph[u]){
+					if(removed[e.to] || e.to == bfs_parents[u]){ continue; }
+					bfs_parents[e.to] = u;
+					queue.push_back(e.to);
+				}
+			}
+			for(const auto u : queue){ sizes[u] = 1; }
+			for(size_t i = queue.size(); i > 1; --i){
+				const auto u = queue[i - 1];
+				sizes[bfs_parents[u]] += sizes[u];
+			}
+			const auto total = queue.size();
+			vertex_t c = r;
+			for(bool moved = true; moved; ){
+				moved = false;
+				for(const auto& e : graph[c]){
+					if(removed[e.to] || e.to == bfs_parents[c]){ continue; }
+					if(sizes[e.to] * 2 > total){
+						c = e.to;
+						moved = true;
+						break;
+					}
+				}
+			}
+			const auto level = (p == n ? 0 : m_levels[p] + 1);
+			m_parents[c] = p;
+			m_levels[c] = level;
+			m_ranks[c] = m_order.size();
+			m_order.push_back(c);
+			removed[c] = true;
+			// vertices of the component in BFS order of each branch
+			if(m_distances.size() < (level + 1) * n){
+				m_distances.resize((level + 1) * n, 0);
+			}
+			m_component_offsets.push_back(m_entries.size());
+			m_branch_offsets.push_back(m_branch_bounds.size());
+			m_entries.push_back(entry{ c, 0 });
+			for(const auto& e : graph[c]){
+				if(removed[e.to]){ continue; }
+				const auto first = m_entries.size();
+				m_branch_bounds.push_back(first);
+				bfs_parents[e.to] = c;
+				m_entries.push_back(entry{ e.to, 1 });
+				for(size_t i = first; i < m_entries.size(); ++i){
+					const auto u = m_entries[i].vertex;
+					const auto d = m_entries[i].distance;
+					for(const auto& f : graph[u]){
+						if(removed[f.to] || f.to == bfs_parents[u]){ continue; }
+						bfs_parents[f.to] = u;
+						m_entries.push_back(entry{ f.to, d + 1 });
+					}
+				}
+				pending.emplace_back(e.to, c);
+			}
+			m_branch_bounds.push_back(m_entries.size());
+			for(size_t i = m_component_offsets.back(); i < m_entries.size(); ++i){
+				m_distances[level * n + m_entries[i].vertex] = m_entries[i].distance;
+			}
+		}
+		m_component_offsets.push_back(m_entries.size());
+		m_branch_offsets.push_back(m_branch_bounds.size());
+	}
+
+
+	size_t size() const {
+		return m_parents.size();
+	}
+
+	/**
+	 * @brief 重心木の根。
+	 */
+	vertex_t root() const {
+		return m_order[0];
+	}
+
+	/**
+	 * @brief 重心木における親。c が根のときは size() を返します。
+	 */
+	vertex_t parent(vertex_t c) const {
+		return m_parents[c];
+	}
+
+	/**
+	 * @brief 重心木における深さ。根のレベルは 0 です。
+	 */
+	size_t level(vertex_t v) const {
+		return m_levels[v];
+	}
+
+	/**
+	 * @brief 頂点 v からレベル k (k <= level(v)) の祖先重心までの距離。
+	 */
+	size_t distance(vertex_t v, size_t k) const {
+		return m_distances[k * size() + v];
+	}
+
+	/**
+	 * @brief 重心 c が担当する成分の頂点。先頭は c 自身です。
+	 */
+	const_iterator component_begin(vertex_t c) const {
+		return m_entries.begin() + m_component_offsets[m_ranks[c]];
+	}
+
+	const_iterator component_end(vertex_t c) const {
+		return m_entries.begin() + m_component_offsets[m_ranks[c] + 1];
+	}
+
+	size_t count_branches(vertex_t c) const {
+		const auto r = m_ranks[c];
+		return m_branch_offsets[r + 1] - m_branch_offsets[r] - 1;
+	}
+
+	/**
+	 * @brief 重心 c の i 番目の分岐に含まれる頂点。距離の昇順に並びます。
+	 */
+	const_iterator branch_begin(vertex_t c, size_t i) const {
+		return m_entries.begin() + m_branch_bounds[m_branch_offsets[m_ranks[c]] + i];
+	}
+
+	const_iterator branch_end(vertex_t c, size_t i) const {
+		return m_entries.begin() + m_branch_bounds[m_branch_offsets[m_ranks[c]] + i + 1];
+	}
+
+	/**
+	 * @brief 重心木を根から BFS 順にたどり、各重心について behavior を呼び出します。
+	 *
+	 * 重心 c ごとに behavior.visit_component(c, first, last) を呼び出します。
+	 * その後、各分岐について behavior.visit_branch(c, first, last) を呼び出します。
+	 * 重心からの距離を用いるパスの数え上げなどで、同じ分岐に含まれる組を取り除くために使用できます。
+	 */
+	template <typename Behavior>
+	void traverse(Behavior& behavior) const {
+		for(const auto c : m_order){
+			behavior.visit_component(c, component_begin(c), component_end(c));
+			const auto k = count_branches(c);
+			for(size_t i = 0; i < k; ++i){
+				behavior.visit_branch(c, branch_begin(c, i), branch_end(c, i));
+			}
+		}
+	}
+
+};
+
+}
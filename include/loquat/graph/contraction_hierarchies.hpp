@@ -0,0 +1,565 @@
+#pragma once
+#include <vector>
+#include <queue>
+#include <functional>
+#include <algorithm>
+#include <utility>
+#include "loquat/graph/adjacency_list.hpp"
+#include "loquat/graph/shortest_path_tree.hpp"
+#include "loquat/container/indexed_d_ary_heap.hpp"
+#include "loquat/math/infinity.hpp"
+#include "loquat/misc/parallel.hpp"
+
+namespace loquat {
+
+namespace detail {
+
+template <typename WeightType>
+struct contraction_arc {
+	using weight_type = WeightType;
+
+	vertex_t to;
+	weight_type weight;
+	vertex_t middle;
+
+	contraction_arc() : to(0), weight(), middle(0) { }
+	contraction_arc(vertex_t t, const weight_type& w, vertex_t m)
+		: to(t), weight(w), middle(m)
+	{ }
+};
+
+template <typename WeightType>
+class contraction_hierarchies_builder {
+
+public:
+	using weight_type = WeightType;
+	using arc_type = contraction_arc<weight_type>;
+
+private:
+	struct shortcut {
+		vertex_t from;
+		vertex_t to;
+		weight_type weight;
+		shortcut(vertex_t f, vertex_t t, const weight_type& w)
+			: from(f), to(t), weight(w)
+		{ }
+	};
+
+	using pair_type = std::pair<weight_type, vertex_t>;
+	using queue_type = std::priority_queue<
+		pair_type, std::vector<pair_type>, std::greater<pair_type>>;
+
+	// per-thread work area of witness searches
+	struct workspace {
+		std::vector<weight_type> dist;
+		std::vector<vertex_t> touched;
+		std::vector<shortcut> shortcuts;
+		queue_type queue;
+
+		explicit workspace(size_t n)
+			: dist(n, positive_infinity<weight_type>())
+			, touched()
+			, shortcuts()
+			, queue()
+		{ }
+	};
+
+	std::vector<std::vector<arc_type>> m_out;
+	std::vector<std::vector<arc_type>> m_in;
+	std::vector<size_t> m_deleted_neighbors;
+	size_t m_settle_limit;
+
+
+	static void insert_arc(
+		std::vector<arc_type>& arcs,
+		vertex_t to, const weight_type& weight, vertex_t middle)
+	{
+		for(auto& a : arcs){
+			if(a.to != to){ continue; }
+			if(weight < a.weight){
+				a.weight = weight;
+				a.middle = middle;
+			}
+			return;
+		}
+		arcs.emplace_back(to, weight, middle);
+	}
+
+	static void erase_arc(std::vector<arc_type>& arcs, vertex_t to){
+		for(size_t i = 0; i < arcs.size(); ++i){
+			if(arcs[i].to != to){ continue; }
+			arcs[i] = arcs.back();
+			arcs.pop_back();
+			return;
+		}
+	}
+
+	void witness_search(
+		vertex_t source, vertex_t avoid, weight_type limit, workspace& ws) const
+	{
+		auto& dist = ws.dist;
+		auto& pq = ws.queue;
+		dist[source] = weight_type();
+		ws.touched.push_back(source);
+		pq.emplace(weight_type(), source);
+		size_t settled = 0;
+		while(!pq.empty() && settled < m_settle_limit){
+			const auto x = pq.top().first;
+			const auto u = pq.top().second;
+			pq.pop();
+			if(dist[u] < x){ continue; }
+			if(limit < x){ break; }
+			++settled;
+			for(const auto& a : m_out[u]){
+				const auto v = a.to;
+				if(v == avoid){ continue; }
+				const auto y = x + a.weight;
+				if(!(y < dist[v])){ continue; }
+				if(is_positive_infinity(dist[v])){ ws.touched.push_back(v); }
+				dist[v] = y;
+				pq.emplace(y, v);
+			}
+		}
+	}
+
+	static void clear_witness(workspace& ws){
+		const auto inf = positive_infinity<weight_type>();
+		for(const auto v : ws.touched){ ws.dist[v] = inf; }
+		ws.touched.clear();
+		while(!ws.queue.empty()){ ws.queue.pop(); }
+	}
+
+	void collect_shortcuts(vertex_t v, workspace& ws) const {
+		ws.shortcuts.clear();
+		weight_type max_out = weight_type();
+		for(const auto& b : m_out[v]){
+			if(max_out < b.weight){ max_out = b.weight; }
+		}
+		for(const auto& a : m_in[v]){
+			const auto u = a.to;
+			witness_search(u, v, a.weight + max_out, ws);
+			for(const auto& b : m_out[v]){
+				const auto w = b.to;
+				if(w == u){ continue; }
+				const auto via = a.weight + b.weight;
+				if(via < ws.dist[w]){ ws.shortcuts.emplace_back(u, w, via); }
+			}
+			clear_witness(ws);
+		}
+	}
+
+	long long priority(vertex_t v, workspace& ws) const {
+		collect_shortcuts(v, ws);
+		return static_cast<long long>(ws.shortcuts.size())
+			- static_cast<long long>(m_in[v].size() + m_out[v].size())
+			+ static_cast<long long>(m_deleted_neighbors[v]);
+	}
+
+	void contract(
+		vertex_t v,
+		const std::vector<shortcut>& shortcuts,
+		std::vector<arc_type>& up,
+		std::vector<arc_type>& down)
+	{
+		for(const auto& s : shortcuts){
+			insert_arc(m_out[s.from], s.to, s.weight, v);
+			insert_arc(m_in[s.to], s.from, s.weight, v);
+		}
+		for(const auto& b : m_out[v]){
+			erase_arc(m_in[b.to], v);
+			++m_deleted_neighbors[b.to];
+		}
+		for(const auto& a : m_in[v]){
+			erase_arc(m_out[a.to], v);
+			++m_deleted_neighbors[a.to];
+		}
+		up.swap(m_out[v]);
+		down.swap(m_in[v]);
+	}
+
+	void build_sequential(
+		std::vector<size_t>& ranks,
+		std::vector<std::vector<arc_type>>& up,
+		std::vector<std::vector<arc_type>>& down)
+	{
+		const auto n = m_out.size();
+		workspace ws(n);
+		indexed_d_ary_heap<long long> heap(n);
+		for(vertex_t v = 0; v < n; ++v){ heap.push(priority(v, ws), v); }
+		size_t next_rank = 0;
+		while(!heap.empty()){
+			const auto v = heap.top().second;
+			heap.pop();
+			// ws.shortcuts holds the shortcuts of v after this call
+			const auto p = priority(v, ws);
+			if(!heap.empty() && heap.top().first < p){
+				heap.push(p, v);
+				continue;
+			}
+			ranks[v] = next_rank++;
+			contract(v, ws.shortcuts, up[v], down[v]);
+		}
+	}
+
+	// contracts independent sets of vertices with locally minimal priorities round by round
+	void build_parallel(
+		std::vector<size_t>& ranks,
+		std::vector<std::vector<arc_type>>& up,
+		std::vector<std::vector<arc_type>>& down,
+		size_t num_threads)
+	{
+		const size_t grain = 64;
+		const auto n = m_out.size();
+		std::vector<workspace> workspaces(num_threads, workspace(n));
+		std::vector<long long> priorities(n);
+		std::vector<unsigned char> selected(n, 0);
+		std::vector<vertex_t> remaining(n), dirty(n), batch;
+		std::vector<std::vector<shortcut>> batch_shortcuts;
+		for(vertex_t v = 0; v < n; ++v){ remaining[v] = dirty[v] = v; }
+		const auto is_before = [&](vertex_t u, vertex_t v){
+			return priorities[u] < priorities[v]
+				|| (priorities[u] == priorities[v] && u < v);
+		};
+		size_t next_rank = 0;
+		while(!remaining.empty()){
+			parallel_for_blocks(num_threads, dirty.size(), grain,
+				[&](size_t t, size_t first, size_t last){
+					for(size_t i = first; i < last; ++i){
+						priorities[dirty[i]] = priority(dirty[i], workspaces[t]);
+					}
+				});
+			parallel_for_blocks(num_threads, remaining.size(), grain,
+				[&](size_t, size_t first, size_t last){
+					for(size_t i = first; i < last; ++i){
+						const auto v = remaining[i];
+						bool minimal = true;
+						for(const auto& a : m_out[v]){ minimal = minimal && is_before(v, a.to); }
+						for(const auto& a : m_in[v]){ minimal = minimal && is_before(v, a.to); }
+						selected[v] = minimal ? 1 : 0;
+					}
+				});
+			batch.clear();
+			size_t tail = 0;
+			for(const auto v : remaining){
+				if(selected[v]){
+					batch.push_back(v);
+				}else{
+					remaining[tail++] = v;
+				}
+			}
+			remaining.resize(tail);
+			batch_shortcuts.resize(batch.size());
+			parallel_for_blocks(num_threads, batch.size(), grain,
+				[&](size_t t, size_t first, size_t last){
+					auto& ws = workspaces[t];
+					for(size_t i = first; i < last; ++i){
+						collect_shortcuts(batch[i], ws);
+						batch_shortcuts[i].swap(ws.shortcuts);
+					}
+				});
+			// vertices in a batch are pairwise non-adjacent, so the order of contraction does not matter
+			dirty.clear();
+			for(size_t i = 0; i < batch.size(); ++i){
+				const auto v = batch[i];
+				for(const auto& a : m_out[v]){ dirty.push_back(a.to); }
+				for(const auto& a : m_in[v]){ dirty.push_back(a.to); }
+				ranks[v] = next_rank++;
+				contract(v, batch_shortcuts[i], up[v], down[v]);
+			}
+			std::sort(dirty.begin(), dirty.end());
+			dirty.erase(std::unique(dirty.begin(), dirty.end()), dirty.end());
+		}
+	}
+
+public:
+	template <typename EdgeType>
+	contraction_hierarchies_builder(
+		const adjacency_list<EdgeType>& graph,
+		size_t settle_limit)
+		: m_out(graph.size())
+		, m_in(graph.size())
+		, m_deleted_neighbors(graph.size())
+		, m_settle_limit(settle_limit)
+	{
+		const auto n = graph.size();
+		for(vertex_t u = 0; u < n; ++u){
+			for(const auto& e : graph[u]){
+				if(e.to == u){ continue; }
+				insert_arc(m_out[u], e.to, e.weight, n);
+				insert_arc(m_in[e.to], u, e.weight, n);
+			}
+		}
+	}
+
+	void build(
+		std::vector<size_t>& ranks,
+		std::vector<std::vector<arc_type>>& up,
+		std::vector<std::vector<arc_type>>& down,
+		size_t num_threads)
+	{
+		const auto n = m_out.size();
+		ranks.assign(n, 0);
+		up.assign(n, std::vector<arc_type>());
+		down.assign(n, std::vector<arc_type>());
+		if(num_threads <= 1){
+			build_sequential(ranks, up, down);
+		}else{
+			build_parallel(ranks, up, down, num_threads);
+		}
+	}
+
+};
+
+}
+
+
+/**
+ * @brief Contraction Hierarchies による二頂点間最短路の高速な計算。
+ * @tparam WeightType 辺の重みの型。重みは非負でなければなりません。
+ *
+ * 構築時に頂点を重要度の低い順に縮約してショートカット辺を追加し、
+ * 順位の高い頂点へ向かう辺のみを CSR 形式で保持します。
+ * 問い合わせは上向きの辺のみを用いた双方向 Dijkstra 法で行われます。
+ */
+template <typename WeightType>
+class contraction_hierarchies {
+
+public:
+	using weight_type = WeightType;
+
+private:
+	using arc_type = detail::contraction_arc<weight_type>;
+	using pair_type = std::pair<weight_type, vertex_t>;
+	using queue_type = std::priority_queue<
+		pair_type, std::vector<pair_type>, std::greater<pair_type>>;
+
+	std::vector<size_t> m_ranks;
+	std::vector<size_t> m_up_offsets;
+	std::vector<arc_type> m_up_arcs;
+	std::vector<size_t> m_down_offsets;
+	std::vector<arc_type> m_down_arcs;
+
+	std::vector<weight_type> m_dist[2];
+	std::vector<vertex_t> m_parents[2];
+	std::vector<vertex_t> m_touched;
+	queue_type m_queues[2];
+
+
+	static void flatten(
+		std::vector<size_t>& offsets,
+		std::vector<arc_type>& arcs,
+		std::vector<std::vector<arc_type>>& lists)
+	{
+		const auto n = lists.size();
+		offsets.assign(n + 1, 0);
+		for(vertex_t u = 0; u < n; ++u){
+			offsets[u + 1] = offsets[u] + lists[u].size();
+		}
+		arcs.clear();
+		arcs.reserve(offsets[n]);
+		for(vertex_t u = 0; u < n; ++u){
+			arcs.insert(arcs.end(), lists[u].begin(), lists[u].end());
+			std::vector<arc_type>().swap(lists[u]);
+		}
+	}
+
+	vertex_t find_middle(vertex_t a, vertex_t b) const {
+		if(m_ranks[a] < m_ranks[b]){
+			for(size_t i = m_up_offsets[a]; i < m_up_offsets[a + 1]; ++i){
+				if(m_up_arcs[i].to == b){ return m_up_arcs[i].middle; }
+			}
+		}else{
+			for(size_t i = m_down_offsets[b]; i < m_down_offsets[b + 1]; ++i){
+				if(m_down_arcs[i].to == a){ return m_down_arcs[i].middle; }
+			}
+		}
+		return size();
+	}
+
+	void unpack(vertex_t a, vertex_t b, std::vector<vertex_t>& path) const {
+		const auto n = size();
+		std::vector<std::pair<vertex_t, vertex_t>> stack;
+		stack.emplace_back(a, b);
+		while(!stack.empty()){
+			const auto p = stack.back();
+			stack.pop_back();
+			const auto m = find_middle(p.first, p.second);
+			if(m == n){
+				path.push_back(p.second);
+			}else{
+				stack.emplace_back(m, p.second);
+				stack.emplace_back(p.first, m);
+			}
+		}
+	}
+
+	vertex_t search(vertex_t source, vertex_t target){
+		const auto inf = positive_infinity<weight_type>();
+		const auto n = size();
+		const std::vector<size_t> *offsets[2] = { &m_up_offsets, &m_down_offsets };
+		const std::vector<arc_type> *arcs[2] = { &m_up_arcs, &m_down_arcs };
+		for(const auto v : m_touched){
+			m_dist[0][v] = m_dist[1][v] = inf;
+			m_parents[0][v] = m_parents[1][v] = n;
+		}
+		m_touched.clear();
+		for(int side = 0; side < 2; ++side){
+			while(!m_queues[side].empty()){ m_queues[side].pop(); }
+		}
+		m_dist[0][source] = weight_type();
+		m_dist[1][target] = weight_type();
+		m_touched.push_back(source);
+		m_touched.push_back(target);
+		m_queues[0].emplace(weight_type(), source);
+		m_queues[1].emplace(weight_type(), target);
+		weight_type best = inf;
+		vertex_t meet = n;
+		while(!m_queues[0].empty() || !m_queues[1].empty()){
+			const auto x0 = m_queues[0].empty() ? inf : m_queues[0].top().first;
+			const auto x1 = m_queues[1].empty() ? inf : m_queues[1].top().first;
+			const int side = (x1 < x0) ? 1 : 0;
+			auto& pq = m_queues[side];
+			const auto x = pq.top().first;
+			const auto u = pq.top().second;
+			if(!is_positive_infinity(best) && !(x < best)){ break; }
+			pq.pop();
+			auto& d = m_dist[side];
+			const auto& o = m_dist[1 - side];
+			if(d[u] < x){ continue; }
+			if(!is_positive_infinity(o[u]) && x + o[u] < best){
+				best = x + o[u];
+				meet = u;
+			}
+			const auto& off = *offsets[side];
+			const auto& as = *arcs[side];
+			for(size_t i = off[u]; i < off[u + 1]; ++i){
+				const auto& a = as[i];
+				const auto v = a.to;
+				const auto y = x + a.weight;
+				if(!(y < d[v])){ continue; }
+				if(is_positive_infinity(m_dist[0][v]) &&
+				   is_positive_infinity(m_dist[1][v]))
+				{
+					m_touched.push_back(v);
+				}
+				d[v] = y;
+				m_parents[side][v] = u;
+				pq.emplace(y, v);
+			}
+		}
+		return meet;
+	}
+
+
+public:
+	contraction_hierarchies()
+		: m_ranks()
+		, m_up_offsets(1)
+		, m_up_arcs()
+		, m_down_offsets(1)
+		, m_down_arcs()
+		, m_dist()
+		, m_parents()
+		, m_touched()
+		, m_queues()
+	{ }
+
+	/**
+	 * @brief グラフの前処理を行う。
+	 * @param graph        重み付き有向グラフ。
+	 * @param settle_limit ショートカットの要否を判定する局所探索で確定させる頂点数の上限。
+	 *                     小さくすると前処理が高速になる代わりにショートカットが増えます。
+	 * @param num_threads  縮約に使用するスレッド数。
+	 *
+	 * num_threads が 1 以下の場合は優先度の最も低い頂点を 1 つずつ縮約します。
+	 * 2 以上の場合は、隣接するどの頂点よりも優先度が低い頂点を独立集合としてまとめて選び、
+	 * それらのショートカットの計算を各スレッドの作業領域で並列に行います。
+	 * 独立集合の頂点どうしは隣接しないため、縮約の結果は処理の順序によりません。
+	 * 得られる順位はスレッド数によらず同じですが、1 つずつ縮約する場合とは異なります。
+	 */
+	template <typename EdgeType>
+	explicit contraction_hierarchies(
+		const adjacency_list<EdgeType>& graph,
+		size_t settle_limit = 500,
+		size_t num_threads = 1)
+		: m_ranks()
+		, m_up_offsets()
+		, m_up_arcs()
+		, m_down_offsets()
+		, m_down_arcs()
+		, m_dist()
+		, m_parents()
+		, m_touched()
+		, m_queues()
+	{
+		const auto n = graph.size();
+		std::vector<std::vector<arc_type>> up, down;
+		detail::contraction_hierarchies_builder<weight_type>(
+			graph, settle_limit).build(m_ranks, up, down, num_threads);
+		flatten(m_up_offsets, m_up_arcs, up);
+		flatten(m_down_offsets, m_down_arcs, down);
+		for(int side = 0; side < 2; ++side){
+			m_dist[side].assign(n, positive_infinity<weight_type>());
+			m_parents[side].assign(n, n);
+		}
+	}
+
+
+	size_t size() const {
+		return m_ranks.size();
+	}
+
+	size_t rank(vertex_t v) const {
+		return m_ranks[v];
+	}
+
+	size_t num_arcs() const {
+		return m_up_arcs.size() + m_down_arcs.size();
+	}
+
+
+	weight_type query(vertex_t source, vertex_t target){
+		const auto meet = search(source, target);
+		if(meet == size()){ return positive_infinity<weight_type>(); }
+		return m_dist[0][meet] + m_dist[1][meet];
+	}
+
+	shortest_path_result<weight_type> shortest_path(
+		vertex_t source, vertex_t target)
+	{
+		const auto n = size();
+		const auto meet = search(source, target);
+		shortest_path_result<weight_type> result;
+		result.distance = positive_infinity<weight_type>();
+		if(meet == n){ return result; }
+		result.distance = m_dist[0][meet] + m_dist[1][meet];
+		std::vector<vertex_t> hubs;
+		for(vertex_t v = meet; v != n; v = m_parents[0][v]){
+			hubs.push_back(v);
+		}
+		std::reverse(hubs.begin(), hubs.end());
+		for(vertex_t v = m_parents[1][meet]; v != n; v = m_parents[1][v]){
+			hubs.push_back(v);
+		}
+		result.path.push_back(hubs[0]);
+		for(size_t i = 0; i + 1 < hubs.size(); ++i){
+			unpack(hubs[i], hubs[i + 1], result.path);
+		}
+		return result;
+	}
+
+};
+
+
+template <typename EdgeType>
+contraction_hierarchies<typename EdgeType::weight_type>
+make_contraction_hierarchies(
+	const adjacency_list<EdgeType>& graph,
+	size_t settle_limit = 500,
+	size_t num_threads = 1)
+{
+	using weight_type = typename EdgeType::weight_type;
+	return contraction_hierarchies<weight_type>(graph, settle_limit, num_threads);
+}
+
+}
@@ -0,0 +1,348 @@
+#pragma once
+#include <vector>
+#include <limits>
+#include <utility>
+#include <iterator>
+#include <unordered_map>
+#include "loquat/graph/adjacency_list.hpp"
+#include "loquat/container/range_query_behavior.hpp"
+#include "loquat/misc/exceptions.hpp"
+
+namespace loquat {
+
+/**
+ * @brief スプレー木で Euler ツアーを管理する動的な森。
+ *
+ * 各頂点と各有向辺をツアー上のノードとして持ち、辺の追加と削除、連結性の判定、
+ * 木全体や部分木に含まれる頂点の値の集約を償却 O(log n) で処理します。
+ * 値はツアーの順にまとめられるため、Behavior の merge は可換であることを想定しています。
+ * ノードは連続した領域に確保され、削除された辺のノードは再利用されます。
+ */
+template <typename Behavior>
+class euler_tour_tree {
+
+public:
+	using behavior_type = Behavior;
+	using value_type = typename behavior_type::value_type;
+
+
+private:
+	static size_t nil(){
+		return std::numeric_limits<size_t>::max();
+	}
+
+	struct node {
+		size_t left;
+		size_t right;
+		size_t parent;
+		size_t size;
+		size_t vertex_count;
+		value_type value;
+		value_type sum;
+	};
+
+	// nodes [0, n) are vertices, the rest are directed edges
+	size_t m_num_vertices;
+	std::vector<node> m_nodes;
+	std::vector<size_t> m_free_nodes;
+	std::unordered_map<size_t, size_t> m_edge_nodes;
+	range_query_behavior_wrapper<behavior_type> m_behavior;
+
+	size_t edge_key(vertex_t u, vertex_t v) const {
+		return u * m_num_vertices + v;
+	}
+
+	void pull(size_t x){
+		auto& t = m_nodes[x];
+		t.size = 1;
+		t.vertex_count = (x < m_num_vertices ? 1 : 0);
+		t.sum = t.value;
+		if(t.left != nil()){
+			const auto& l = m_nodes[t.left];
+			t.size += l.size;
+			t.vertex_count += l.vertex_count;
+			t.sum = m_behavior.merge(l.sum, t.sum);
+		}
+		if(t.right != nil()){
+			const auto& r = m_nodes[t.right];
+			t.size += r.size;
+			t.vertex_count += r.vertex_count;
+			t.sum = m_behavior.merge(t.sum, r.sum);
+		}
+	}
+
+	void rotate(size_t x){
+		const auto y = m_nodes[x].parent;
+		const auto z = m_nodes[y].parent;
+		size_t b;
+		if(m_nodes[y].left == x){
+			b = m_nodes[x].right;
+			m_nodes[y].left = b;
+			m_nodes[x].right = y;
+		}else{
+			b = m_nodes[x].left;
+			m_nodes[y].right = b;
+			m_nodes[x].left = y;
+		}
+		if(b != nil()){ m_nodes[b].parent = y; }
+		if(z != nil()){
+			if(m_nodes[z].left == y){
+				m_nodes[z].left = x;
+			}else{
+				m_nodes[z].right = x;
+			}
+		}
+		m_nodes[y].parent = x;
+		m_nodes[x].parent = z;
+		pull(y);
+		pull(x);
+	}
+
+	void splay(size_t x){
+		while(m_nodes[x].parent != nil()){
+			const auto y = m_nodes[x].parent;
+			const auto z = m_nodes[y].parent;
+			if(z != nil()){
+				const bool zigzig =
+					(m_nodes[z].left == y) == (m_nodes[y].left == x);
+				rotate(zigzig ? y : x);
+			}
+			rotate(x);
+		}
+	}
+
+	size_t merge(size_t a, size_t b){
+		if(a == nil()){ return b; }
+		if(b == nil()){ return a; }
+		splay(a);
+		while(m_nodes[a].right != nil()){ a = m_nodes[a].right; }
+		splay(a);
+		m_nodes[a].right = b;
+		m_nodes[b].parent = a;
+		pull(a);
+		return a;
+	}
+
+	// splits the tour into the part before x and the part starting at x
+	std::pair<size_t, size_t> split_before(size_t x){
+		splay(x);
+		const auto l = m_nodes[x].left;
+		if(l != nil()){
+			m_nodes[l].parent = nil();
+			m_nodes[x].left = nil();
+			pull(x);
+		}
+		return std::make_pair(l, x);
+	}
+
+	// splits the tour into the part ending at x and the part after x
+	std::pair<size_t, size_t> split_after(size_t x){
+		splay(x);
+		const auto r = m_nodes[x].right;
+		if(r != nil()){
+			m_nodes[r].parent = nil();
+			m_nodes[x].right = nil();
+			pull(x);
+		}
+		return std::make_pair(x, r);
+	}
+
+	size_t allocate_edge_node(vertex_t u, vertex_t v){
+		const auto x = m_behavior.identity();
+		const node e = { nil(), nil(), nil(), 1, 0, x, x };
+		size_t k;
+		if(m_free_nodes.empty()){
+			k = m_nodes.size();
+			m_nodes.push_back(e);
+		}else{
+			k = m_free_nodes.back();
+			m_free_nodes.pop_back();
+			m_nodes[k] = e;
+		}
+		m_edge_nodes[edge_key(u, v)] = k;
+		return k;
+	}
+
+	void release_edge_node(vertex_t u, vertex_t v){
+		const auto it = m_edge_nodes.find(edge_key(u, v));
+		m_free_nodes.push_back(it->second);
+		m_edge_nodes.erase(it);
+	}
+
+	size_t find_edge_node(vertex_t u, vertex_t v) const {
+		const auto it = m_edge_nodes.find(edge_key(u, v));
+		return it == m_edge_nodes.end() ? nil() : it->second;
+	}
+
+	size_t index_of(size_t x){
+		splay(x);
+		const auto l = m_nodes[x].left;
+		return l == nil() ? 0 : m_nodes[l].size;
+	}
+
+	// rotates the tour so that it starts at v
+	size_t reroot(vertex_t v){
+		const auto p = split_before(v);
+		return merge(p.second, p.first);
+	}
+
+	void initialize(size_t n){
+		const auto x = m_behavior.identity();
+		m_nodes.assign(n, node{ nil(), nil(), nil(), 1, 1, x, x });
+		m_nodes.reserve(n + 2 * (n > 0 ? n - 1 : 0));
+	}
+
+
+public:
+	euler_tour_tree()
+		: m_num_vertices(0)
+		, m_nodes()
+		, m_free_nodes()
+		, m_edge_nodes()
+		, m_behavior()
+	{ }
+
+	explicit euler_tour_tree(
+		size_t n,
+		const behavior_type& behavior = behavior_type())
+		: m_num_vertices(n)
+		, m_nodes()
+		, m_free_nodes()
+		, m_edge_nodes()
+		, m_behavior(behavior)
+	{
+		initialize(n);
+	}
+
+	template <typename Iterator>
+	euler_tour_tree(
+		Iterator first,
+		Iterator last,
+		const behavior_type& behavior = behavior_type())
+		: euler_tour_tree(std::distance(first, last), behavior)
+	{
+		vertex_t v = 0;
+		for(auto it = first; it != last; ++it, ++v){
+			m_nodes[v].value = m_nodes[v].sum = *it;
+		}
+	}
+
+	/**
+	 * @brief 森 forest の辺をすべて追加した状態で構築します。
+	 *
+	 * forest は各辺を両方向に持つ無向の森でなければなりません。
+	 */
+	template <typename EdgeType>
+	explicit euler_tour_tree(
+		const adjacency_list<EdgeType>& forest,
+		const behavior_type& behavior = behavior_type())
+		: euler_tour_tree(forest.size(), behavior)
+	{
+		for(vertex_t u = 0; u < forest.size(); ++u){
+			for(const auto& e : forest[u]){
+				if(u < e.to){ link(u, e.to); }
+			}
+		}
+	}
+
+
+	size_t size() const {
+		return m_num_vertices;
+	}
+
+	bool connected(vertex_t u, vertex_t v){
+		if(u == v){ return true; }
+		splay(u);
+		splay(v);
+		return m_nodes[u].parent != nil();
+	}
+
+	/**
+	 * @brief 頂点 v を含む木の Euler ツアーが v から始まるように回転させます。
+	 */
+	void evert(vertex_t v){
+		reroot(v);
+	}
+
+	/**
+	 * @brief 頂点 u と v の間に辺を追加します。
+	 * @return u と v がすでに連結であった場合は辺を追加せずに false を返します。
+	 */
+	bool link(vertex_t u, vertex_t v){
+		if(connected(u, v)){ return false; }
+		const auto a = reroot(u);
+		const auto b = reroot(v);
+		const auto uv = allocate_edge_node(u, v);
+		const auto vu = allocate_edge_node(v, u);
+		merge(merge(merge(a, uv), b), vu);
+		return true;
+	}
+
+	/**
+	 * @brief 頂点 u と v の間の辺を削除します。
+	 * @return u と v の間に辺が存在しなかった場合は false を返します。
+	 */
+	bool cut(vertex_t u, vertex_t v){
+		auto first = find_edge_node(u, v);
+		if(first == nil()){ return false; }
+		auto second = find_edge_node(v, u);
+		if(index_of(first) > index_of(second)){ std::swap(first, second); }
+		// the tour is A first B second C, where B is one of the separated trees
+		const auto a = split_before(first).first;
+		split_after(first);
+		split_before(second);
+		const auto c = split_after(second).second;
+		merge(a, c);
+		release_edge_node(u, v);
+		release_edge_node(v, u);
+		return true;
+	}
+
+	/**
+	 * @brief 頂点 v を含む木の頂点数。
+	 */
+	size_t tree_size(vertex_t v){
+		splay(v);
+		return m_nodes[v].vertex_count;
+	}
+
+	value_type get(vertex_t v) const {
+		return m_nodes[v].value;
+	}
+
+	void update(vertex_t v, const value_type& x){
+		splay(v);
+		m_nodes[v].value = x;
+		pull(v);
+	}
+
+	/**
+	 * @brief 頂点 v を含む木に含まれる頂点の値をまとめます。
+	 */
+	value_type query_tree(vertex_t v){
+		splay(v);
+		return m_nodes[v].sum;
+	}
+
+	/**
+	 * @brief 辺 (parent, v) を取り除いたときに v 側に残る頂点の値をまとめます。
+	 *
+	 * 辺が存在しない場合は loquat::no_solution_error を送出します。
+	 */
+	value_type query_subtree(vertex_t v, vertex_t parent){
+		const auto down = find_edge_node(parent, v);
+		if(down == nil()){
+			throw no_solution_error("edge does not exist");
+		}
+		const auto up = find_edge_node(v, parent);
+		reroot(parent);
+		const auto a = split_after(down);
+		const auto b = split_before(up);
+		const auto result = m_nodes[b.first].sum;
+		merge(merge(a.first, b.first), b.second);
+		return result;
+	}
+
+};
+
+}
@@ -0,0 +1,247 @@
+#pragma once
+#include <vector>
+#include "loquat/graph/adjacency_list.hpp"
+#include "loquat/misc/parallel.hpp"
+
+namespace loquat {
+
+/**
+ * @brief 頂点を一続きの位置に並べる重軽分解。
+ *
+ * 各頂点に重い子を先にたどる先行順の位置を割り当てます。
+ * 各重パスと各部分木はそれぞれ連続した位置の区間になります。
+ * そのため、パスに対するクエリを 1 つの区間クエリ用コンテナで処理できます。
+ */
+class flat_heavy_light_decomposition {
+
+public:
+	using index_type = size_t;
+
+
+private:
+	std::vector<vertex_t> m_parents;
+	std::vector<size_t> m_depths;
+	std::vector<size_t> m_subtree_sizes;
+	std::vector<vertex_t> m_heads;
+	std::vector<index_type> m_positions;
+	std::vector<vertex_t> m_vertices;
+
+
+public:
+	flat_heavy_light_decomposition()
+		: m_parents()
+		, m_depths()
+		, m_subtree_sizes()
+		, m_heads()
+		, m_positions()
+		, m_vertices()
+	{ }
+
+	/**
+	 * @param num_threads 構築に使用するスレッド数。
+	 *
+	 * num_threads が 2 以上の場合、根から幅優先探索を行い、未訪問の頂点が num_threads の 4 倍以上ある
+	 * 最初の深さで打ち切ります。その深さの頂点を根とする部分木は互いに素なので、
+	 * それぞれの探索、部分木の大きさの計算、位置の割り当てをスレッドごとに並列に行います。
+	 * 結果はスレッド数によりません。
+	 */
+	template <typename EdgeType>
+	explicit flat_heavy_light_decomposition(
+		const adjacency_list<EdgeType>& graph,
+		vertex_t root = 0,
+		size_t num_threads = 1)
+		: m_parents(graph.size(), graph.size())
+		, m_depths(graph.size(), 0)
+		, m_subtree_sizes(graph.size(), 1)
+		, m_heads(graph.size())
+		, m_positions(graph.size())
+		, m_vertices(graph.size())
+	{
+		const auto n = graph.size();
+		if(n == 0){ return; }
+		// BFS order near the root is stored into m_vertices temporarily
+		auto& order = m_vertices;
+		const size_t min_frontier =
+			(num_threads <= 1) ? n + 1 : 4 * num_threads;
+		size_t head = 0, tail = 0;
+		order[tail++] = root;
+		while(head < tail && tail - head < min_frontier){
+			for(const auto level_end = tail; head < level_end; ++head){
+				const auto u = order[head];
+				for(const auto& e : graph[u]){
+					if(e.to == m_parents[u]){ continue; }
+					visit_child(u, e.to);
+					order[tail++] = e.to;
+				}
+			}
+		}
+		// subtrees rooted at order[head, tail) are processed in parallel
+		thread_pool pool(num_threads);
+		const auto num_subtrees = tail - head;
+		std::vector<std::vector<vertex_t>> subtree_orders(num_subtrees);
+		pool.for_blocks(num_subtrees, 1, [&](size_t, size_t first, size_t last){
+			for(size_t i = first; i < last; ++i){
+				auto& local = subtree_orders[i];
+				local.push_back(order[head + i]);
+				for(size_t j = 0; j < local.size(); ++j){
+					const auto u = local[j];
+					for(const auto& e : graph[u]){
+						if(e.to == m_parents[u]){ continue; }
+						visit_child(u, e.to);
+						local.push_back(e.to);
+					}
+				}
+				for(size_t j = local.size(); j > 1; --j){
+					const auto v = local[j - 1];
+					m_subtree_sizes[m_parents[v]] += m_subtree_sizes[v];
+				}
+			}
+		});
+		for(size_t i = tail; i > 1; --i){
+			const auto v = order[i - 1];
+			m_subtree_sizes[m_parents[v]] += m_subtree_sizes[v];
+		}
+		// pre-order positions visiting the heavy child first
+		m_heads[root] = root;
+		m_positions[root] = 0;
+		for(size_t i = 0; i < head; ++i){ place_children(graph, order[i]); }
+		pool.for_blocks(num_subtrees, 1, [&](size_t, size_t first, size_t last){
+			for(size_t i = first; i < last; ++i){
+				for(const auto u : subtree_orders[i]){ place_children(graph, u); }
+			}
+		});
+		for(vertex_t v = 0; v < n; ++v){
+			m_vertices[m_positions[v]] = v;
+		}
+	}
+
+
+	size_t size() const {
+		return m_parents.size();
+	}
+
+	/**
+	 * @brief 頂点 v の親。v が根のときは size() を返します。
+	 */
+	vertex_t parent(vertex_t v) const {
+		return m_parents[v];
+	}
+
+	size_t depth(vertex_t v) const {
+		return m_depths[v];
+	}
+
+	size_t subtree_size(vertex_t v) const {
+		return m_subtree_sizes[v];
+	}
+
+	/**
+	 * @brief 頂点 v を含む重パスの根に最も近い頂点。
+	 */
+	vertex_t head(vertex_t v) const {
+		return m_heads[v];
+	}
+
+	index_type position(vertex_t v) const {
+		return m_positions[v];
+	}
+
+	vertex_t vertex(index_type i) const {
+		return m_vertices[i];
+	}
+
+	vertex_t lowest_common_ancestor(vertex_t a, vertex_t b) const {
+		while(m_heads[a] != m_heads[b]){
+			if(m_depths[m_heads[a]] > m_depths[m_heads[b]]){
+				a = m_parents[m_heads[a]];
+			}else{
+				b = m_parents[m_heads[b]];
+			}
+		}
+		return m_depths[a] < m_depths[b] ? a : b;
+	}
+
+	/**
+	 * @brief 頂点 u と v を結ぶ辺に対応する位置。子の側の頂点の位置です。
+	 */
+	index_type edge_position(vertex_t u, vertex_t v) const {
+		return m_depths[u] < m_depths[v] ? m_positions[v] : m_positions[u];
+	}
+
+	/**
+	 * @brief s から t へのパスを位置の区間 [first, last) に分解して func(first, last, upward) を呼び出します。
+	 *
+	 * upward が true の区間は s 側の部分で、位置の降順にたどられ、パス上の順に呼び出されます。
+	 * upward が false の区間は t 側の部分で、位置の昇順にたどられ、パス上の逆順に呼び出されます。
+	 * 作業領域は確保しません。
+	 */
+	template <typename Func>
+	void for_each_segment(vertex_t s, vertex_t t, Func func) const {
+		visit_path(s, t, 0, func);
+	}
+
+	/**
+	 * @brief for_each_segment と同様ですが、パス上の辺の位置 (loquat::flat_heavy_light_decomposition::edge_position) を列挙します。
+	 */
+	template <typename Func>
+	void for_each_edge_segment(vertex_t s, vertex_t t, Func func) const {
+		visit_path(s, t, 1, func);
+	}
+
+
+private:
+	void visit_child(vertex_t u, vertex_t v){
+		m_parents[v] = u;
+		m_depths[v] = m_depths[u] + 1;
+	}
+
+	// assigns heads and positions to the children of u, whose position is already fixed
+	template <typename EdgeType>
+	void place_children(const adjacency_list<EdgeType>& graph, vertex_t u){
+		const auto n = graph.size();
+		vertex_t heavy = n;
+		for(const auto& e : graph[u]){
+			const auto v = e.to;
+			if(v == m_parents[u]){ continue; }
+			if(heavy == n || m_subtree_sizes[heavy] < m_subtree_sizes[v]){
+				heavy = v;
+			}
+		}
+		if(heavy == n){ return; }
+		auto next = m_positions[u] + 1;
+		m_heads[heavy] = m_heads[u];
+		m_positions[heavy] = next;
+		next += m_subtree_sizes[heavy];
+		for(const auto& e : graph[u]){
+			const auto v = e.to;
+			if(v == m_parents[u] || v == heavy){ continue; }
+			m_heads[v] = v;
+			m_positions[v] = next;
+			next += m_subtree_sizes[v];
+		}
+	}
+
+	// skip is the number of positions to exclude at the lowest common ancestor
+	template <typename Func>
+	void visit_path(vertex_t s, vertex_t t, size_t skip, Func& func) const {
+		while(m_heads[s] != m_heads[t]){
+			if(m_depths[m_heads[s]] > m_depths[m_heads[t]]){
+				func(m_positions[m_heads[s]], m_positions[s] + 1, true);
+				s = m_parents[m_heads[s]];
+			}else{
+				func(m_positions[m_heads[t]], m_positions[t] + 1, false);
+				t = m_parents[m_heads[t]];
+			}
+		}
+		if(m_positions[s] >= m_positions[t]){
+			if(m_positions[t] + skip <= m_positions[s]){
+				func(m_positions[t] + skip, m_positions[s] + 1, true);
+			}
+		}else{
+			func(m_positions[s] + skip, m_positions[t] + 1, false);
+		}
+	}
+
+};
+
+}
@@ -0,0 +1,154 @@
+#pragma once
+#include <vector>
+#include <deque>
+#include <utility>
+#include <algorithm>
+#include "loquat/graph/adjacency_list.hpp"
+#include "loquat/graph/edge.hpp"
+#include "loquat/graph/residual_network.hpp"
+#include "loquat/graph/maxflow_dinitz.hpp"
+#include "loquat/graph/min_cut.hpp"
+#include "loquat/math/infinity.hpp"
+#include "loquat/misc/parallel.hpp"
+
+namespace loquat {
+
+namespace detail {
+
+template <typename EdgeType>
+class gomory_hu_tree_impl {
+
+public:
+	using capacity_type = typename EdgeType::capacity_type;
+	using residual_edge_type = residual_edge<EdgeType>;
+	using residual_type = adjacency_list<residual_edge_type>;
+	using result_edge_type = edge<edge_param::weight<capacity_type>>;
+
+
+private:
+	// residual network and Dinitz work area owned by one thread
+	struct workspace {
+		residual_type residual;
+		maxflow_dinitz_impl<residual_edge_type> impl;
+
+		explicit workspace(const residual_type& initial)
+			: residual(initial)
+			, impl(residual)
+		{ }
+	};
+
+	// minimum s-t cut computed speculatively with the parent t of s at the start of a round
+	struct cut {
+		vertex_t s;
+		vertex_t t;
+		capacity_type flow;
+		std::vector<bool> side;
+	};
+
+	residual_type m_initial;
+	std::vector<vertex_t> m_parents;
+	std::vector<capacity_type> m_flows;
+
+	void compute(cut& c, workspace& ws) const {
+		ws.residual = m_initial;
+		c.flow = ws.impl.push(c.s, c.t, positive_infinity<capacity_type>());
+		c.side = min_cut_source_side(c.s, ws.residual);
+	}
+
+	void apply(const cut& c){
+		const auto n = m_parents.size();
+		const auto s = c.s, t = c.t;
+		const auto& side = c.side;
+		m_flows[s] = c.flow;
+		for(vertex_t v = 0; v < n; ++v){
+			if(v != s && side[v] && m_parents[v] == t){ m_parents[v] = s; }
+		}
+		if(t != 0 && side[m_parents[t]]){
+			m_parents[s] = m_parents[t];
+			m_parents[t] = s;
+			m_flows[s] = m_flows[t];
+			m_flows[t] = c.flow;
+		}
+	}
+
+
+public:
+	explicit gomory_hu_tree_impl(const adjacency_list<EdgeType>& graph)
+		: m_initial(make_residual(graph))
+		, m_parents(graph.size(), 0)
+		, m_flows(graph.size())
+	{ }
+
+	adjacency_list<result_edge_type> solve(size_t num_threads){
+		const auto n = m_parents.size();
+		thread_pool pool(num_threads);
+		std::deque<workspace> workspaces;
+		for(size_t i = 0; i < pool.size(); ++i){ workspaces.emplace_back(m_initial); }
+		std::vector<cut> batch;
+		for(vertex_t first = 1; first < n; ){
+			const auto last = std::min<vertex_t>(first + pool.size(), n);
+			// keeps the cuts of the previous round whose parents have not changed
+			std::vector<cut> next(last - first);
+			for(vertex_t s = first; s < last; ++s){
+				auto& c = next[s - first];
+				c.s = s;
+				c.t = m_parents[s];
+				for(auto& b : batch){
+					if(b.s == s && b.t == c.t){ c = std::move(b); }
+				}
+			}
+			batch.swap(next);
+			pool.for_blocks(batch.size(), 1,
+				[&](size_t t, size_t lo, size_t hi){
+					for(size_t i = lo; i < hi; ++i){
+						if(batch[i].side.empty()){ compute(batch[i], workspaces[t]); }
+					}
+				});
+			// cuts are valid only while the parent used for them is still the parent of s
+			size_t applied = 0;
+			while(applied < batch.size() &&
+			      m_parents[batch[applied].s] == batch[applied].t)
+			{
+				apply(batch[applied++]);
+			}
+			first += static_cast<vertex_t>(applied);
+		}
+		adjacency_list<result_edge_type> result(n);
+		for(vertex_t v = 1; v < n; ++v){
+			result.add_edge(v, m_parents[v], m_flows[v]);
+			result.add_edge(m_parents[v], v, m_flows[v]);
+		}
+		return result;
+	}
+
+};
+
+}
+
+
+/**
+ * @brief Gusfield の方法による Gomory-Hu 木の構築。
+ * @param graph       無向グラフ。各無向辺は両方向の辺として表現されている必要があります。
+ * @param num_threads 最大流の計算に使用するスレッド数の上限。
+ * @return 辺の重みがカットの容量である木。
+ *         任意の 2 頂点間の最小カットの容量は木上のパスに含まれる辺の重みの最小値に等しくなります。
+ *
+ * 最大流の計算を頂点数 - 1 回行います。
+ * 頂点 s の最大流は、その時点での木における s の親を終点とするため、直前までの結果に依存します。
+ * そこで連続する num_threads 個の頂点について、ラウンド開始時の親を終点とする最大流を
+ * スレッドごとの残余ネットワークと作業領域で投機的に並列に計算し、先頭から順に木へ反映します。
+ * 反映の途中で親が変わった頂点以降は次のラウンドで計算し直すため、結果は逐次に計算した場合と一致します。
+ */
+template <typename EdgeType>
+adjacency_list<edge<edge_param::weight<typename EdgeType::capacity_type>>>
+gomory_hu_tree(const adjacency_list<EdgeType>& graph, size_t num_threads){
+	return detail::gomory_hu_tree_impl<EdgeType>(graph).solve(num_threads);
+}
+
+template <typename EdgeType>
+adjacency_list<edge<edge_param::weight<typename EdgeType::capacity_type>>>
+gomory_hu_tree(const adjacency_list<EdgeType>& graph){
+	return gomory_hu_tree(graph, hardware_concurrency());
+}
+
+}
@@ -1,10 +1,9 @@
 #pragma once
 #include <vector>
-#include <stack>
 #include <algorithm>
 #include <limits>
 #include "loquat/graph/adjacency_list.hpp"
-#include "loquat/graph/tree_utility.hpp"
+#include "loquat/graph/flat_heavy_light_decomposition.hpp"
 #include "loquat/container/range_query_behavior.hpp"
 #include "loquat/container/lazy_range_query_behavior.hpp"
 
@@ -27,19 +26,17 @@ public:
 	};
 
 private:
-	struct path {
-		vertex_t parent;
-		size_t rank;
-		std::vector<vertex_t> vertices;
-	};
-
-	std::vector<path> m_paths;
+	std::vector<vertex_t> m_path_parents;
+	std::vector<size_t> m_path_ranks;
+	std::vector<size_t> m_path_lengths;
 	std::vector<index_type> m_vertex2path;
 	std::vector<index_type> m_vertex2index;
 
 public:
 	heavy_light_decomposition()
-		: m_paths()
+		: m_path_parents()
+		, m_path_ranks()
+		, m_path_lengths()
 		, m_vertex2path()
 		, m_vertex2index()
 	{ }
@@ -47,48 +44,40 @@ public:
 	template <typename EdgeType>
 	explicit heavy_light_decomposition(
 		const adjacency_list<EdgeType>& graph,
-		vertex_t root = 0)
-		: m_paths()
-		, m_vertex2path(graph.size())
-		, m_vertex2index(graph.size())
+		vertex_t root = 0,
+		size_t num_threads = 1)
+		: heavy_light_decomposition(
+			flat_heavy_light_decomposition(graph, root, num_threads))
+	{ }
+
+	/**
+	 * @brief 平坦化された重軽分解から各重パスを取り出します。
+	 *
+	 * 重パスは位置の昇順に番号付けされ、位置の順に 1 回走査するだけで構築されます。
+	 */
+	explicit heavy_light_decomposition(
+		const flat_heavy_light_decomposition& flat)
+		: m_path_parents()
+		, m_path_ranks()
+		, m_path_lengths()
+		, m_vertex2path(flat.size())
+		, m_vertex2index(flat.size())
 	{
-		struct frame_type {
-			vertex_t u;
-			vertex_t p;
-			frame_type() : u(0), p(0) { }
-			frame_type(vertex_t u, vertex_t p) : u(u), p(p) { }
-		};
 		const vertex_t nil = std::numeric_limits<vertex_t>::max();
-		const auto subtree_sizes = compute_subtree_sizes(graph, root);
-		std::stack<frame_type> frame_stack;
-		frame_stack.emplace(root, nil);
-		while(!frame_stack.empty()){
-			const auto f = frame_stack.top();
-			frame_stack.pop();
-			const index_type path_id = m_paths.size();
-			path p;
-			p.parent = f.p;
-			p.rank = (f.p != nil ? m_paths[m_vertex2path[f.p]].rank + 1 : 0);
-			vertex_t cur = f.u;
-			while(cur != nil){
-				const auto ss = subtree_sizes[cur];
-				const auto threshold = ss / 2;
-				m_vertex2path[cur] = path_id;
-				m_vertex2index[cur] = p.vertices.size();
-				p.vertices.push_back(cur);
-				vertex_t heavy_edge = nil;
-				for(const auto& e : graph[cur]){
-					const auto v = e.to;
-					if(subtree_sizes[v] > subtree_sizes[cur]){ continue; }
-					if(heavy_edge == nil && subtree_sizes[v] >= threshold){
-						heavy_edge = v;
-					}else{
-						frame_stack.emplace(v, cur);
-					}
-				}
-				cur = heavy_edge;
+		const auto n = flat.size();
+		for(index_type i = 0; i < n; ++i){
+			const auto v = flat.vertex(i);
+			const auto h = flat.head(v);
+			if(h == v){
+				const auto p = flat.parent(v);
+				const bool is_root = (p == n);
+				m_path_parents.push_back(is_root ? nil : p);
+				m_path_ranks.push_back(
+					is_root ? 0 : m_path_ranks[m_vertex2path[p]] + 1);
+				m_path_lengths.push_back(0);
 			}
-			m_paths.push_back(p);
+			m_vertex2path[v] = m_path_lengths.size() - 1;
+			m_vertex2index[v] = m_path_lengths.back()++;
 		}
 	}
 
@@ -97,15 +86,15 @@ public:
 	}
 
 	size_t count_heavy_paths() const {
-		return m_paths.size();
+		return m_path_lengths.size();
 	}
 
 	size_t path_length(index_type p) const {
-		return m_paths[p].vertices.size();
+		return m_path_lengths[p];
 	}
 
 	vertex_t parent(index_type p) const {
-		return m_paths[p].parent;
+		return m_path_parents[p];
 	}
 
 	index_type path_id(vertex_t v) const {
@@ -121,16 +110,16 @@ public:
 		index_type s_path = path_id(s), s_index = local_index(s);
 		index_type t_path = path_id(t), t_index = local_index(t);
 		while(s_path != t_path){
-			const size_t s_rank = m_paths[s_path].rank;
-			const size_t t_rank = m_paths[t_path].rank;
+			const size_t s_rank = m_path_ranks[s_path];
+			const size_t t_rank = m_path_ranks[t_path];
 			if(s_rank >= t_rank){
-				const auto parent = m_paths[s_path].parent;
+				const auto parent = m_path_parents[s_path];
 				s_segments.push_back(segment(s_path, s_index, 0));
 				s_path  = path_id(parent);
 				s_index = local_index(parent);
 			}
 			if(t_rank >= s_rank){
-				const auto parent = m_paths[t_path].parent;
+				const auto parent = m_path_parents[t_path];
 				t_segments.push_back(segment(t_path, 0, t_index));
 				t_path  = path_id(parent);
 				t_index = local_index(parent);
@@ -155,14 +144,14 @@ public:
 	using value_type = typename behavior_type::value_type;
 
 private:
-	heavy_light_decomposition m_decomposition;
-	std::vector<range_queryable_type> m_range_queryables;
+	flat_heavy_light_decomposition m_decomposition;
+	range_queryable_type m_range_queryable;
 	range_query_behavior_wrapper<behavior_type> m_behavior;
 
 public:
 	vertex_path_queryable_tree()
 		: m_decomposition()
-		, m_range_queryables()
+		, m_range_queryable()
 		, m_behavior()
 	{ }
 
@@ -172,16 +161,9 @@ public:
 		vertex_t root = 0,
 		const behavior_type& behavior = behavior_type())
 		: m_decomposition(graph, root)
-		, m_range_queryables()
+		, m_range_queryable(graph.size(), behavior)
 		, m_behavior(behavior)
-	{
-		const size_t n_paths = m_decomposition.count_heavy_paths();
-		m_range_queryables.reserve(n_paths);
-		for(size_t i = 0; i < n_paths; ++i){
-			m_range_queryables.emplace_back(
-				m_decomposition.path_length(i), behavior);
-		}
-	}
+	{ }
 
 	template <typename Iterator, typename EdgeType>
 	explicit vertex_path_queryable_tree(
@@ -191,47 +173,45 @@ public:
 		vertex_t root = 0,
 		const behavior_type& behavior = behavior_type())
 		: m_decomposition(graph, root)
-		, m_range_queryables()
+		, m_range_queryable()
 		, m_behavior(behavior)
 	{
-		const size_t n_paths = m_decomposition.count_heavy_paths();
-		std::vector<std::vector<value_type>> initial_values(n_paths);
-		for(size_t i = 0; i < n_paths; ++i){
-			initial_values[i].resize(m_decomposition.path_length(i));
-		}
+		std::vector<value_type> initial_values(graph.size());
 		auto it = first;
 		for(vertex_t i = 0; it != last; ++it, ++i){
-			const auto path_id = m_decomposition.path_id(i);
-			const auto local_index = m_decomposition.local_index(i);
-			initial_values[path_id][local_index] = *it;
-		}
-		m_range_queryables.reserve(n_paths);
-		for(size_t i = 0; i < n_paths; ++i){
-			m_range_queryables.emplace_back(
-				initial_values[i].begin(), initial_values[i].end(), behavior);
+			initial_values[m_decomposition.position(i)] = *it;
 		}
+		m_range_queryable = range_queryable_type(
+			initial_values.begin(), initial_values.end(), behavior);
 	}
 
 	void update(vertex_t v, const value_type& x){
-		const auto path_id = m_decomposition.path_id(v);
-		const auto local_index = m_decomposition.local_index(v);
-		m_range_queryables[path_id].update(local_index, x);
+		m_range_queryable.update(m_decomposition.position(v), x);
 	}
 
 	value_type query(vertex_t s, vertex_t t){
-		const auto shortest_path = m_decomposition.shortest_path(s, t);
-		value_type acc = m_behavior.identity();
-		for(const auto& s : shortest_path){
-			const auto path_id = s.path_id;
-			const auto lo = std::min(s.first, s.last);
-			const auto hi = std::max(s.first, s.last) + 1;
-			const auto partial = m_range_queryables[path_id].query(lo, hi);
-			const auto directed_partial = s.first > s.last
-				? m_behavior.reverse(hi - lo, partial)
-				: partial;
-			acc = m_behavior.merge(acc, directed_partial);
-		}
-		return acc;
+		value_type up = m_behavior.identity();
+		value_type down = m_behavior.identity();
+		m_decomposition.for_each_segment(s, t,
+			[&](size_t lo, size_t hi, bool upward){
+				const auto partial = m_range_queryable.query(lo, hi);
+				if(upward){
+					up = m_behavior.merge(up, m_behavior.reverse(hi - lo, partial));
+				}else{
+					down = m_behavior.merge(partial, down);
+				}
+			});
+		return m_behavior.merge(up, down);
+	}
+
+	/**
+	 * @brief 頂点 v を根とする部分木に含まれる頂点の値をまとめます。
+	 *
+	 * 値は重い子を先にたどる先行順にまとめられます。
+	 */
+	value_type query_subtree(vertex_t v){
+		const auto lo = m_decomposition.position(v);
+		return m_range_queryable.query(lo, lo + m_decomposition.subtree_size(v));
 	}
 
 };
@@ -247,14 +227,22 @@ public:
 	using modifier_type = typename behavior_type::modifier_type;
 
 private:
-	heavy_light_decomposition m_decomposition;
-	std::vector<range_queryable_type> m_range_queryables;
+	flat_heavy_light_decomposition m_decomposition;
+	range_queryable_type m_range_queryable;
 	lazy_range_query_behavior_wrapper<behavior_type> m_behavior;
 
+	// the part of m applied to k vertices starting at the offset-th vertex
+	modifier_type slice_modifier(
+		const modifier_type& m, size_t offset, size_t k) const
+	{
+		return m_behavior.split_modifier(
+			m_behavior.split_modifier(m, offset).second, k).first;
+	}
+
 public:
 	lazy_vertex_path_queryable_tree()
 		: m_decomposition()
-		, m_range_queryables()
+		, m_range_queryable()
 		, m_behavior()
 	{ }
 
@@ -264,16 +252,9 @@ public:
 		vertex_t root = 0,
 		const behavior_type& behavior = behavior_type())
 		: m_decomposition(graph, root)
-		, m_range_queryables()
+		, m_range_queryable(graph.size(), behavior)
 		, m_behavior(behavior)
-	{
-		const size_t n_paths = m_decomposition.count_heavy_paths();
-		m_range_queryables.reserve(n_paths);
-		for(size_t i = 0; i < n_paths; ++i){
-			m_range_queryables.emplace_back(
-				m_decomposition.path_length(i), behavior);
-		}
-	}
+	{ }
 
 	template <typename Iterator, typename EdgeType>
 	explicit lazy_vertex_path_queryable_tree(
@@ -283,64 +264,233 @@ public:
 		vertex_t root = 0,
 		const behavior_type& behavior = behavior_type())
 		: m_decomposition(graph, root)
-		, m_range_queryables()
+		, m_range_queryable()
 		, m_behavior(behavior)
 	{
-		const size_t n_paths = m_decomposition.count_heavy_paths();
-		std::vector<std::vector<value_type>> initial_values(n_paths);
-		for(size_t i = 0; i < n_paths; ++i){
-			initial_values[i].resize(m_decomposition.path_length(i));
-		}
+		std::vector<value_type> initial_values(graph.size());
 		auto it = first;
 		for(vertex_t i = 0; it != last; ++it, ++i){
-			const auto path_id = m_decomposition.path_id(i);
-			const auto local_index = m_decomposition.local_index(i);
-			initial_values[path_id][local_index] = *it;
-		}
-		m_range_queryables.reserve(n_paths);
-		for(size_t i = 0; i < n_paths; ++i){
-			m_range_queryables.emplace_back(
-				initial_values[i].begin(), initial_values[i].end(), behavior);
+			initial_values[m_decomposition.position(i)] = *it;
 		}
+		m_range_queryable = range_queryable_type(
+			initial_values.begin(), initial_values.end(), behavior);
 	}
 
 	void update(vertex_t v, const value_type& x){
-		const auto path_id = m_decomposition.path_id(v);
-		const auto local_index = m_decomposition.local_index(v);
-		m_range_queryables[path_id].update(local_index, x);
+		m_range_queryable.update(m_decomposition.position(v), x);
 	}
 
 	void modify(vertex_t s, vertex_t t, const modifier_type& m){
-		const auto shortest_path = m_decomposition.shortest_path(s, t);
-		modifier_type modifier = m;
-		for(const auto& s : shortest_path){
-			const auto path_id = s.path_id;
-			const auto lo = std::min(s.first, s.last);
-			const auto hi = std::max(s.first, s.last) + 1;
-			const auto modifier_pair =
-				m_behavior.split_modifier(modifier, hi - lo);
-			const auto head_modifier = s.first > s.last
-				? m_behavior.reverse_modifier(hi - lo, modifier_pair.first)
-				: modifier_pair.first;
-			m_range_queryables[path_id].modify(lo, hi, head_modifier);
-			modifier = modifier_pair.second;
-		}
+		const auto& decomp = m_decomposition;
+		const auto w = decomp.lowest_common_ancestor(s, t);
+		const auto s_length = decomp.depth(s) - decomp.depth(w);
+		decomp.for_each_segment(s, t,
+			[&](size_t lo, size_t hi, bool upward){
+				const auto k = hi - lo;
+				if(upward){
+					const auto offset = decomp.depth(s) - decomp.depth(decomp.vertex(hi - 1));
+					m_range_queryable.modify(lo, hi,
+						m_behavior.reverse_modifier(k, slice_modifier(m, offset, k)));
+				}else{
+					const auto offset = s_length + decomp.depth(decomp.vertex(lo)) - decomp.depth(w);
+					m_range_queryable.modify(lo, hi, slice_modifier(m, offset, k));
+				}
+			});
 	}
 
 	value_type query(vertex_t s, vertex_t t){
-		const auto shortest_path = m_decomposition.shortest_path(s, t);
-		value_type acc = m_behavior.identity_value();
-		for(const auto& s : shortest_path){
-			const auto path_id = s.path_id;
-			const auto lo = std::min(s.first, s.last);
-			const auto hi = std::max(s.first, s.last) + 1;
-			const auto partial = m_range_queryables[path_id].query(lo, hi);
-			const auto directed_partial = s.first > s.last
-				? m_behavior.reverse_value(hi - lo, partial)
-				: partial;
-			acc = m_behavior.merge_value(acc, directed_partial);
-		}
-		return acc;
+		value_type up = m_behavior.identity_value();
+		value_type down = m_behavior.identity_value();
+		m_decomposition.for_each_segment(s, t,
+			[&](size_t lo, size_t hi, bool upward){
+				const auto partial = m_range_queryable.query(lo, hi);
+				if(upward){
+					up = m_behavior.merge_value(up, m_behavior.reverse_value(hi - lo, partial));
+				}else{
+					down = m_behavior.merge_value(partial, down);
+				}
+			});
+		return m_behavior.merge_value(up, down);
+	}
+
+	/**
+	 * @brief 頂点 v を根とする部分木に含まれる頂点に modifier を作用させます。
+	 *
+	 * 部分木の頂点は重い子を先にたどる先行順に並べた区間として扱われます。
+	 */
+	void modify_subtree(vertex_t v, const modifier_type& m){
+		const auto lo = m_decomposition.position(v);
+		m_range_queryable.modify(lo, lo + m_decomposition.subtree_size(v), m);
+	}
+
+	/**
+	 * @brief 頂点 v を根とする部分木に含まれる頂点の値をまとめます。
+	 */
+	value_type query_subtree(vertex_t v){
+		const auto lo = m_decomposition.position(v);
+		return m_range_queryable.query(lo, lo + m_decomposition.subtree_size(v));
+	}
+
+};
+
+
+/**
+ * @brief 辺に値を持つ木に対するパスクエリ。
+ *
+ * 各辺の値は子の側の頂点の位置に格納されます。
+ */
+template <typename RangeQueryable>
+class edge_path_queryable_tree {
+	
+public:
+	using range_queryable_type = RangeQueryable;
+	using behavior_type = typename range_queryable_type::behavior_type;
+	using value_type = typename behavior_type::value_type;
+
+private:
+	flat_heavy_light_decomposition m_decomposition;
+	range_queryable_type m_range_queryable;
+	range_query_behavior_wrapper<behavior_type> m_behavior;
+
+public:
+	edge_path_queryable_tree()
+		: m_decomposition()
+		, m_range_queryable()
+		, m_behavior()
+	{ }
+
+	template <typename EdgeType>
+	explicit edge_path_queryable_tree(
+		const adjacency_list<EdgeType>& graph,
+		vertex_t root = 0,
+		const behavior_type& behavior = behavior_type())
+		: m_decomposition(graph, root)
+		, m_range_queryable(graph.size(), behavior)
+		, m_behavior(behavior)
+	{ }
+
+	/**
+	 * @brief 頂点 u と v を結ぶ辺の値を x に更新します。
+	 */
+	void update(vertex_t u, vertex_t v, const value_type& x){
+		m_range_queryable.update(m_decomposition.edge_position(u, v), x);
+	}
+
+	value_type query(vertex_t s, vertex_t t){
+		value_type up = m_behavior.identity();
+		value_type down = m_behavior.identity();
+		m_decomposition.for_each_edge_segment(s, t,
+			[&](size_t lo, size_t hi, bool upward){
+				const auto partial = m_range_queryable.query(lo, hi);
+				if(upward){
+					up = m_behavior.merge(up, m_behavior.reverse(hi - lo, partial));
+				}else{
+					down = m_behavior.merge(partial, down);
+				}
+			});
+		return m_behavior.merge(up, down);
+	}
+
+	/**
+	 * @brief 頂点 v を根とする部分木に含まれる辺の値をまとめます。
+	 */
+	value_type query_subtree(vertex_t v){
+		const auto lo = m_decomposition.position(v);
+		return m_range_queryable.query(lo + 1, lo + m_decomposition.subtree_size(v));
+	}
+
+};
+
+
+template <typename RangeQueryable>
+class lazy_edge_path_queryable_tree {
+	
+public:
+	using range_queryable_type = RangeQueryable;
+	using behavior_type = typename range_queryable_type::behavior_type;
+	using value_type = typename behavior_type::value_type;
+	using modifier_type = typename behavior_type::modifier_type;
+
+private:
+	flat_heavy_light_decomposition m_decomposition;
+	range_queryable_type m_range_queryable;
+	lazy_range_query_behavior_wrapper<behavior_type> m_behavior;
+
+	modifier_type slice_modifier(
+		const modifier_type& m, size_t offset, size_t k) const
+	{
+		return m_behavior.split_modifier(
+			m_behavior.split_modifier(m, offset).second, k).first;
+	}
+
+public:
+	lazy_edge_path_queryable_tree()
+		: m_decomposition()
+		, m_range_queryable()
+		, m_behavior()
+	{ }
+
+	template <typename EdgeType>
+	explicit lazy_edge_path_queryable_tree(
+		const adjacency_list<EdgeType>& graph,
+		vertex_t root = 0,
+		const behavior_type& behavior = behavior_type())
+		: m_decomposition(graph, root)
+		, m_range_queryable(graph.size(), behavior)
+		, m_behavior(behavior)
+	{ }
+
+	void update(vertex_t u, vertex_t v, const value_type& x){
+		m_range_queryable.update(m_decomposition.edge_position(u, v), x);
+	}
+
+	void modify(vertex_t s, vertex_t t, const modifier_type& m){
+		const auto& decomp = m_decomposition;
+		const auto w = decomp.lowest_common_ancestor(s, t);
+		const auto s_length = decomp.depth(s) - decomp.depth(w);
+		decomp.for_each_edge_segment(s, t,
+			[&](size_t lo, size_t hi, bool upward){
+				const auto k = hi - lo;
+				if(upward){
+					const auto offset = decomp.depth(s) - decomp.depth(decomp.vertex(hi - 1));
+					m_range_queryable.modify(lo, hi,
+						m_behavior.reverse_modifier(k, slice_modifier(m, offset, k)));
+				}else{
+					const auto offset = s_length + decomp.depth(decomp.vertex(lo)) - decomp.depth(w) - 1;
+					m_range_queryable.modify(lo, hi, slice_modifier(m, offset, k));
+				}
+			});
+	}
+
+	value_type query(vertex_t s, vertex_t t){
+		value_type up = m_behavior.identity_value();
+		value_type down = m_behavior.identity_value();
+		m_decomposition.for_each_edge_segment(s, t,
+			[&](size_t lo, size_t hi, bool upward){
+				const auto partial = m_range_queryable.query(lo, hi);
+				if(upward){
+					up = m_behavior.merge_value(up, m_behavior.reverse_value(hi - lo, partial));
+				}else{
+					down = m_behavior.merge_value(partial, down);
+				}
+			});
+		return m_behavior.merge_value(up, down);
+	}
+
+	/**
+	 * @brief 頂点 v を根とする部分木に含まれる辺に modifier を作用させます。
+	 */
+	void modify_subtree(vertex_t v, const modifier_type& m){
+		const auto lo = m_decomposition.position(v);
+		m_range_queryable.modify(lo + 1, lo + m_decomposition.subtree_size(v), m);
+	}
+
+	/**
+	 * @brief 頂点 v を根とする部分木に含まれる辺の値をまとめます。
+	 */
+	value_type query_subtree(vertex_t v){
+		const auto lo = m_decomposition.position(v);
+		return m_range_queryable.query(lo + 1, lo + m_decomposition.subtree_size(v));
 	}
 
 };
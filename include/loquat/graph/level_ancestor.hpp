@@ -0,0 +1,277 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+#include "loquat/graph/adjacency_list.hpp"
+#include "loquat/math/bitmanip.hpp"
+#include "loquat/misc/exceptions.hpp"
+
+namespace loquat {
+
+/**
+ * @brief ラダー分解とジャンプポインタによる祖先クエリ。
+ *
+ * 木を最長パスに分解し、各パスを長さの分だけ根の方向に延長したラダーを作ります。
+ * 部分木の頂点数が B = max(1, floor(log2 n) / 4) 未満の頂点を小さな木 (micro tree) にまとめ、
+ * 残りの頂点のうち子がすべて micro tree に属する頂点 (macro leaf) にのみジャンプポインタを持たせます。
+ * macro leaf は互いに素な B 頂点以上の部分木を持つため、ジャンプポインタの総数は O(n / B * log n) = O(n) です。
+ * macro leaf から 2^j 個上の頂点へ移動すると、残りは移動先のラダー上で求まります。
+ * micro tree 内の移動は、同じ形の木で共有する表を引いて求めます。表の大きさは O(sqrt(n) log^2 n) です。
+ * クエリは O(1) で、頂点番号は 32 ビットで保持するため、頂点数は 2^32 未満である必要があります。
+ */
+class level_ancestor {
+
+public:
+	using index_type = uint32_t;
+
+
+private:
+	struct micro_tree {
+		// vertices in preorder are m_micro_vertices[offset, ...)
+		index_type offset;
+		index_type table_offset;
+		index_type parent;
+	};
+
+	index_type m_micro_size;
+	std::vector<index_type> m_depth;
+	std::vector<bool> m_is_micro;
+	// macro vertices: index in m_ladders, micro vertices: preorder index in the micro tree
+	std::vector<index_type> m_positions;
+	// macro vertices: offset of the jump block of a macro leaf below,
+	// micro vertices: index of the micro tree
+	std::vector<index_type> m_blocks;
+	std::vector<index_type> m_ladders;
+	// a jump block is the macro leaf followed by its 2^j-th ancestors
+	std::vector<index_type> m_jumps;
+	std::vector<micro_tree> m_micro_trees;
+	std::vector<index_type> m_micro_vertices;
+	std::vector<uint8_t> m_micro_tables;
+
+
+public:
+	level_ancestor()
+		: m_micro_size(1)
+		, m_depth()
+		, m_is_micro()
+		, m_positions()
+		, m_blocks()
+		, m_ladders()
+		, m_jumps()
+		, m_micro_trees()
+		, m_micro_vertices()
+		, m_micro_tables()
+	{ }
+
+	template <typename EdgeType>
+	level_ancestor(vertex_t root, const adjacency_list<EdgeType>& g)
+		: m_micro_size(1)
+		, m_depth(g.size(), 0)
+		, m_is_micro(g.size(), false)
+		, m_positions(g.size())
+		, m_blocks(g.size())
+		, m_ladders()
+		, m_jumps()
+		, m_micro_trees()
+		, m_micro_vertices()
+		, m_micro_tables()
+	{
+		const auto n = g.size();
+		const auto nil = static_cast<index_type>(n);
+		if(n == 0){ return; }
+
+		// BFS order and parents; children of u are order[child_begin[u], child_end[u])
+		std::vector<index_type> order(1, static_cast<index_type>(root));
+		std::vector<index_type> parents(n, nil), child_begin(n), child_end(n);
+		order.reserve(n);
+		for(size_t head = 0; head < order.size(); ++head){
+			const auto u = order[head];
+			child_begin[u] = static_cast<index_type>(order.size());
+			for(const auto& e : g[u]){
+				const auto v = static_cast<index_type>(e.to);
+				if(v == parents[u]){ continue; }
+				parents[v] = u;
+				m_depth[v] = m_depth[u] + 1;
+				order.push_back(v);
+			}
+			child_end[u] = static_cast<index_type>(order.size());
+		}
+
+		// subtree sizes, heights and long-path children
+		std::vector<index_type> sizes(n, 1), heights(n, 1), long_child(n, nil);
+		for(size_t i = order.size(); i > 1; --i){
+			const auto v = order[i - 1];
+			const auto p = parents[v];
+			sizes[p] += sizes[v];
+			if(heights[p] < heights[v] + 1){
+				heights[p] = heights[v] + 1;
+				long_child[p] = v;
+			}
+		}
+		const index_type log_n =
+			31u - bitmanip::clz(static_cast<index_type>(n));
+		m_micro_size = std::max<index_type>(1, log_n / 4);
+		for(vertex_t v = 0; v < n; ++v){
+			m_is_micro[v] = (sizes[v] < m_micro_size);
+		}
+
+		// ladders of long paths starting at macro vertices, extended upward by their lengths
+		m_ladders.reserve(2 * n);
+		for(const auto t : order){
+			if(m_is_micro[t]){ continue; }
+			if(t != root && long_child[parents[t]] == t){ continue; }
+			const auto h = heights[t];
+			const auto start = m_ladders.size();
+			index_type a = t;
+			for(index_type k = 0; k < h && parents[a] != nil; ++k){
+				a = parents[a];
+				m_ladders.push_back(a);
+			}
+			std::reverse(m_ladders.begin() + start, m_ladders.end());
+			for(auto v = t; v != nil; v = long_child[v]){
+				m_positions[v] = static_cast<index_type>(m_ladders.size());
+				m_ladders.push_back(v);
+			}
+		}
+
+		// jump blocks of macro leaves, using the root path of a DFS over macro vertices
+		std::vector<bool> is_macro_leaf(n);
+		for(vertex_t v = 0; v < n; ++v){ is_macro_leaf[v] = !m_is_micro[v]; }
+		for(vertex_t v = 0; v < n; ++v){
+			if(v != root && !m_is_micro[v]){ is_macro_leaf[parents[v]] = false; }
+		}
+		std::vector<index_type> path, iterators(child_begin);
+		path.push_back(static_cast<index_type>(root));
+		while(!path.empty()){
+			const auto u = path.back();
+			if(iterators[u] < child_end[u]){
+				const auto c = order[iterators[u]++];
+				if(!m_is_micro[c]){ path.push_back(c); }
+				continue;
+			}
+			if(is_macro_leaf[u]){
+				m_blocks[u] = static_cast<index_type>(m_jumps.size());
+				m_jumps.push_back(u);
+				const auto d = m_depth[u];
+				for(index_type step = 1; step <= d; step <<= 1){
+					m_jumps.push_back(path[d - step]);
+					if(step > d / 2){ break; }
+				}
+			}
+			path.pop_back();
+		}
+		for(size_t i = order.size(); i > 0; --i){
+			const auto v = order[i - 1];
+			if(m_is_micro[v] || is_macro_leaf[v]){ continue; }
+			for(auto k = child_begin[v]; k < child_end[v]; ++k){
+				const auto c = order[k];
+				if(!m_is_micro[c]){
+					m_blocks[v] = m_blocks[c];
+					break;
+				}
+			}
+		}
+
+		// micro trees encoded by their DFS shapes, sharing tables of local ancestors
+		if(m_micro_size < 2){ return; }
+		const index_type width = m_micro_size - 1;
+		std::vector<index_type> shape_tables(
+			size_t(1) << (2 * m_micro_size - 3), nil);
+		std::vector<uint8_t> local_parents;
+		for(const auto r : order){
+			if(!m_is_micro[r] || m_is_micro[parents[r]]){ continue; }
+			micro_tree t;
+			t.offset = static_cast<index_type>(m_micro_vertices.size());
+			t.parent = parents[r];
+			const auto id = static_cast<index_type>(m_micro_trees.size());
+			index_type code = 1;
+			local_parents.assign(1, 0);
+			m_blocks[r] = id;
+			m_positions[r] = 0;
+			m_micro_vertices.push_back(r);
+			path.assign(1, r);
+			while(!path.empty()){
+				const auto u = path.back();
+				if(iterators[u] < child_end[u]){
+					const auto c = order[iterators[u]++];
+					code = (code << 1) | 1;
+					m_blocks[c] = id;
+					m_positions[c] = static_cast<index_type>(local_parents.size());
+					local_parents.push_back(static_cast<uint8_t>(m_positions[u]));
+					m_micro_vertices.push_back(c);
+					path.push_back(c);
+					continue;
+				}
+				path.pop_back();
+				if(!path.empty()){ code <<= 1; }
+			}
+			if(shape_tables[code] == nil){
+				shape_tables[code] = static_cast<index_type>(m_micro_tables.size());
+				const auto s = local_parents.size();
+				m_micro_tables.resize(m_micro_tables.size() + s * width, 0);
+				for(size_t x = 0; x < s; ++x){
+					auto a = static_cast<uint8_t>(x);
+					for(index_type k = 0; ; ++k){
+						m_micro_tables[shape_tables[code] + x * width + k] = a;
+						if(a == 0){ break; }
+						a = local_parents[a];
+					}
+				}
+			}
+			t.table_offset = shape_tables[code];
+			m_micro_trees.push_back(t);
+		}
+	}
+
+
+	size_t size() const {
+		return m_depth.size();
+	}
+
+	size_t depth(vertex_t v) const {
+		return m_depth[v];
+	}
+
+	/**
+	 * @brief 頂点 v から k 個親をたどった頂点を返します。
+	 */
+	vertex_t kth_ancestor(vertex_t v, size_t k) const {
+		if(k > m_depth[v]){
+			throw no_solution_error("vertex does not have k-th ancestor");
+		}
+		if(m_is_micro[v]){
+			const auto& t = m_micro_trees[m_blocks[v]];
+			const auto r = m_micro_vertices[t.offset];
+			const size_t local_depth = m_depth[v] - m_depth[r];
+			if(k <= local_depth){
+				const auto i = t.table_offset
+					+ static_cast<size_t>(m_positions[v]) * (m_micro_size - 1) + k;
+				return m_micro_vertices[t.offset + m_micro_tables[i]];
+			}
+			k -= local_depth + 1;
+			v = t.parent;
+		}
+		if(k == 0){ return v; }
+		const auto block = m_blocks[v];
+		const auto leaf = m_jumps[block];
+		const auto distance =
+			static_cast<index_type>(k + m_depth[leaf] - m_depth[v]);
+		const auto j = 31u - bitmanip::clz(distance);
+		const auto u = m_jumps[block + 1 + j];
+		const auto rest = distance - (index_type(1) << j);
+		return m_ladders[m_positions[u] - rest];
+	}
+
+	/**
+	 * @brief 頂点 v の祖先のうち深さが d である頂点を返します。
+	 */
+	vertex_t ancestor_at_depth(vertex_t v, size_t d) const {
+		if(d > m_depth[v]){
+			throw no_solution_error("vertex does not have an ancestor at the depth");
+		}
+		return kth_ancestor(v, m_depth[v] - d);
+	}
+
+};
+
+}
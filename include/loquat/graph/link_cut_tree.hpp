@@ -0,0 +1,430 @@
+#pragma once
+#include <vector>
+#include <utility>
+#include <iterator>
+#include <algorithm>
+#include "loquat/graph/adjacency_list.hpp"
+#include "loquat/container/range_query_behavior.hpp"
+#include "loquat/container/lazy_range_query_behavior.hpp"
+#include "loquat/misc/exceptions.hpp"
+
+namespace loquat {
+
+/**
+ * @brief スプレー木による link-cut 木。
+ *
+ * 森に対する辺の追加と削除、根の変更、パス上の値の集約と作用を償却 O(log n) で処理します。
+ * 頂点の値は lazy_range_query_behavior の要件を満たす Behavior で扱います。
+ * パスの向きを反転させる際には reverse_value と reverse_modifier を使用するため、
+ * 非可換な演算も扱えます。ノードは頂点数分の連続した領域に確保されます。
+ */
+template <typename Behavior>
+class lazy_link_cut_tree {
+
+public:
+	using behavior_type = Behavior;
+	using value_type = typename behavior_type::value_type;
+	using modifier_type = typename behavior_type::modifier_type;
+
+
+private:
+	struct node {
+		vertex_t left;
+		vertex_t right;
+		vertex_t parent;
+		size_t size;
+		bool reversed;
+		bool modified;
+		value_type value;
+		value_type sum;
+		modifier_type modifier;
+	};
+
+	// the last node is a sentinel representing an empty subtree
+	std::vector<node> m_nodes;
+	std::vector<vertex_t> m_stack;
+	lazy_range_query_behavior_wrapper<behavior_type> m_behavior;
+
+	vertex_t nil() const {
+		return m_nodes.size() - 1;
+	}
+
+	bool is_splay_root(vertex_t x) const {
+		const auto p = m_nodes[x].parent;
+		return p == nil() || (m_nodes[p].left != x && m_nodes[p].right != x);
+	}
+
+	void flip(vertex_t x){
+		if(x == nil()){ return; }
+		auto& t = m_nodes[x];
+		t.reversed = !t.reversed;
+		t.sum = m_behavior.reverse_value(t.size, t.sum);
+		if(t.modified){
+			t.modifier = m_behavior.reverse_modifier(t.size, t.modifier);
+		}
+	}
+
+	void apply(vertex_t x, const modifier_type& m){
+		if(x == nil()){ return; }
+		auto& t = m_nodes[x];
+		const auto left_size = t.reversed
+			? m_nodes[t.right].size
+			: m_nodes[t.left].size;
+		const auto rest = m_behavior.split_modifier(m, left_size).second;
+		t.value = m_behavior.modify(
+			1, t.value, m_behavior.split_modifier(rest, 1).first);
+		t.sum = m_behavior.modify(t.size, t.sum, m);
+		t.modifier = t.modified ? m_behavior.merge_modifier(t.modifier, m) : m;
+		t.modified = true;
+	}
+
+	void push(vertex_t x){
+		auto& t = m_nodes[x];
+		if(t.reversed){
+			std::swap(t.left, t.right);
+			flip(t.left);
+			flip(t.right);
+			t.reversed = false;
+		}
+		if(t.modified){
+			const auto a = m_behavior.split_modifier(
+				t.modifier, m_nodes[t.left].size);
+			const auto b = m_behavior.split_modifier(a.second, 1);
+			apply(t.left, a.first);
+			apply(t.right, b.second);
+			t.modifier = m_behavior.identity_modifier();
+			t.modified = false;
+		}
+	}
+
+	void pull(vertex_t x){
+		auto& t = m_nodes[x];
+		const auto& l = m_nodes[t.left];
+		const auto& r = m_nodes[t.right];
+		t.size = l.size + 1 + r.size;
+		t.sum = m_behavior.merge_value(
+			m_behavior.merge_value(l.sum, t.value), r.sum);
+	}
+
+	void rotate(vertex_t x){
+		const auto y = m_nodes[x].parent;
+		const auto z = m_nodes[y].parent;
+		vertex_t b;
+		if(m_nodes[y].left == x){
+			b = m_nodes[x].right;
+			m_nodes[y].left = b;
+			m_nodes[x].right = y;
+		}else{
+			b = m_nodes[x].left;
+			m_nodes[y].right = b;
+			m_nodes[x].left = y;
+		}
+		if(b != nil()){ m_nodes[b].parent = y; }
+		if(z != nil()){
+			if(m_nodes[z].left == y){
+				m_nodes[z].left = x;
+			}else if(m_nodes[z].right == y){
+				m_nodes[z].right = x;
+			}
+		}
+		m_nodes[y].parent = x;
+		m_nodes[x].parent = z;
+		pull(y);
+		pull(x);
+	}
+
+	void splay(vertex_t x){
+		m_stack.clear();
+		for(vertex_t y = x; ; y = m_nodes[y].parent){
+			m_stack.push_back(y);
+			if(is_splay_root(y)){ break; }
+		}
+		while(!m_stack.empty()){
+			push(m_stack.back());
+			m_stack.pop_back();
+		}
+		while(!is_splay_root(x)){
+			const auto y = m_nodes[x].parent;
+			if(!is_splay_root(y)){
+				const auto z = m_nodes[y].parent;
+				const bool zigzig =
+					(m_nodes[z].left == y) == (m_nodes[y].left == x);
+				rotate(zigzig ? y : x);
+			}
+			rotate(x);
+		}
+	}
+
+	// makes the path from the root to x preferred and returns the last vertex jumped to
+	vertex_t access(vertex_t x){
+		vertex_t last = nil();
+		for(vertex_t y = x; y != nil(); y = m_nodes[y].parent){
+			splay(y);
+			m_nodes[y].right = last;
+			pull(y);
+			last = y;
+		}
+		splay(x);
+		return last;
+	}
+
+	void expose_path(vertex_t s, vertex_t t){
+		if(!connected(s, t)){
+			throw no_solution_error("vertices are not connected");
+		}
+		evert(s);
+		access(t);
+	}
+
+
+public:
+	lazy_link_cut_tree()
+		: m_nodes()
+		, m_stack()
+		, m_behavior()
+	{ }
+
+	explicit lazy_link_cut_tree(
+		size_t n,
+		const behavior_type& behavior = behavior_type())
+		: m_nodes()
+		, m_stack()
+		, m_behavior(behavior)
+	{
+		const auto x = m_behavior.identity_value();
+		const auto m = m_behavior.identity_modifier();
+		m_nodes.assign(n + 1, node{ n, n, n, 1, false, false, x, x, m });
+		m_nodes[n].size = 0;
+	}
+
+	template <typename Iterator>
+	lazy_link_cut_tree(
+		Iterator first,
+		Iterator last,
+		const behavior_type& behavior = behavior_type())
+		: lazy_link_cut_tree(std::distance(first, last), behavior)
+	{
+		vertex_t v = 0;
+		for(auto it = first; it != last; ++it, ++v){
+			m_nodes[v].value = m_nodes[v].sum = *it;
+		}
+	}
+
+
+	size_t size() const {
+		return m_nodes.empty() ? 0 : m_nodes.size() - 1;
+	}
+
+	/**
+	 * @brief 頂点 v を含む木の根。
+	 */
+	vertex_t root(vertex_t v){
+		access(v);
+		vertex_t x = v;
+		push(x);
+		while(m_nodes[x].left != nil()){
+			x = m_nodes[x].left;
+			push(x);
+		}
+		splay(x);
+		return x;
+	}
+
+	bool connected(vertex_t u, vertex_t v){
+		return root(u) == root(v);
+	}
+
+	/**
+	 * @brief 頂点 v を含む木の根を v に変更します。
+	 */
+	void evert(vertex_t v){
+		access(v);
+		flip(v);
+		push(v);
+	}
+
+	/**
+	 * @brief 頂点 u と v の間に辺を追加します。
+	 * @return u と v がすでに連結であった場合は辺を追加せずに false を返します。
+	 *
+	 * u を含む木は根が u に変更され、v の子として接続されます。
+	 */
+	bool link(vertex_t u, vertex_t v){
+		if(connected(u, v)){ return false; }
+		evert(u);
+		m_nodes[u].parent = v;
+		return true;
+	}
+
+	/**
+	 * @brief 頂点 u と v の間の辺を削除します。
+	 * @return u と v の間に辺が存在しなかった場合は false を返します。
+	 */
+	bool cut(vertex_t u, vertex_t v){
+		if(u == v || !connected(u, v)){ return false; }
+		evert(u);
+		access(v);
+		if(m_nodes[v].left != u || m_nodes[v].size != 2){ return false; }
+		m_nodes[v].left = nil();
+		m_nodes[u].parent = nil();
+		pull(v);
+		return true;
+	}
+
+	/**
+	 * @brief 現在の根に関する u と v の最小共通祖先。連結でない場合は size() を返します。
+	 */
+	vertex_t lowest_common_ancestor(vertex_t u, vertex_t v){
+		if(!connected(u, v)){ return size(); }
+		access(u);
+		return access(v);
+	}
+
+	value_type get(vertex_t v){
+		access(v);
+		return m_nodes[v].value;
+	}
+
+	void update(vertex_t v, const value_type& x){
+		access(v);
+		m_nodes[v].value = x;
+		pull(v);
+	}
+
+	/**
+	 * @brief s から t へのパス上の頂点の値を順にまとめます。
+	 *
+	 * s と t が連結でない場合は loquat::no_solution_error を送出します。
+	 * s を含む木の根は s に変更されます。
+	 */
+	value_type query(vertex_t s, vertex_t t){
+		expose_path(s, t);
+		return m_nodes[t].sum;
+	}
+
+	/**
+	 * @brief s から t へのパス上の頂点に順に modifier を作用させます。
+	 *
+	 * s と t が連結でない場合は loquat::no_solution_error を送出します。
+	 * s を含む木の根は s に変更されます。
+	 */
+	void modify(vertex_t s, vertex_t t, const modifier_type& m){
+		expose_path(s, t);
+		apply(t, m);
+	}
+
+};
+
+
+namespace detail {
+
+template <typename Behavior>
+class link_cut_tree_behavior_adaptor {
+
+public:
+	using value_type = typename Behavior::value_type;
+	struct modifier_type { };
+
+private:
+	range_query_behavior_wrapper<Behavior> m_behavior;
+
+public:
+	link_cut_tree_behavior_adaptor() : m_behavior() { }
+
+	explicit link_cut_tree_behavior_adaptor(const Behavior& behavior)
+		: m_behavior(behavior)
+	{ }
+
+	value_type identity_value() const {
+		return m_behavior.identity();
+	}
+
+	modifier_type identity_modifier() const {
+		return modifier_type();
+	}
+
+	modifier_type merge_modifier(const modifier_type&, const modifier_type&) const {
+		return modifier_type();
+	}
+
+	value_type merge_value(const value_type& a, const value_type& b) const {
+		return m_behavior.merge(a, b);
+	}
+
+	value_type modify(size_t, const value_type& v, const modifier_type&) const {
+		return v;
+	}
+
+	value_type reverse_value(size_t n, const value_type& x) const {
+		return m_behavior.reverse(n, x);
+	}
+
+};
+
+}
+
+
+/**
+ * @brief range_query_behavior の要件を満たす Behavior による link-cut 木。
+ *
+ * パスに対する作用を持たないこと以外は loquat::lazy_link_cut_tree と同じです。
+ */
+template <typename Behavior>
+class link_cut_tree {
+
+public:
+	using behavior_type = Behavior;
+	using value_type = typename behavior_type::value_type;
+
+
+private:
+	using adaptor_type = detail::link_cut_tree_behavior_adaptor<behavior_type>;
+
+	lazy_link_cut_tree<adaptor_type> m_impl;
+
+
+public:
+	link_cut_tree()
+		: m_impl()
+	{ }
+
+	explicit link_cut_tree(
+		size_t n,
+		const behavior_type& behavior = behavior_type())
+		: m_impl(n, adaptor_type(behavior))
+	{ }
+
+	template <typename Iterator>
+	link_cut_tree(
+		Iterator first,
+		Iterator last,
+		const behavior_type& behavior = behavior_type())
+		: m_impl(first, last, adaptor_type(behavior))
+	{ }
+
+
+	size_t size() const { return m_impl.size(); }
+
+	vertex_t root(vertex_t v){ return m_impl.root(v); }
+
+	bool connected(vertex_t u, vertex_t v){ return m_impl.connected(u, v); }
+
+	void evert(vertex_t v){ m_impl.evert(v); }
+
+	bool link(vertex_t u, vertex_t v){ return m_impl.link(u, v); }
+
+	bool cut(vertex_t u, vertex_t v){ return m_impl.cut(u, v); }
+
+	vertex_t lowest_common_ancestor(vertex_t u, vertex_t v){
+		return m_impl.lowest_common_ancestor(u, v);
+	}
+
+	value_type get(vertex_t v){ return m_impl.get(v); }
+
+	void update(vertex_t v, const value_type& x){ m_impl.update(v, x); }
+
+	value_type query(vertex_t s, vertex_t t){ return m_impl.query(s, t); }
+
+};
+
+}
@@ -1,6 +1,8 @@
 #pragma once
 #include <vector>
 #include <stack>
+#include <algorithm>
+#include <limits>
 #include "loquat/graph/adjacency_list.hpp"
 
 namespace loquat {
@@ -0,0 +1,76 @@
+#pragma once
+#include <vector>
+#include <utility>
+#include "loquat/container/disjoint_set.hpp"
+#include "loquat/graph/adjacency_list.hpp"
+
+namespace loquat {
+
+/**
+ * @brief Tarjan のオフラインアルゴリズムによる最小共通祖先。
+ * @param queries 最小共通祖先を求める頂点の組のリスト。
+ * @return 各クエリに対する最小共通祖先。
+ *
+ * 深さ優先探索 1 回と union-find で全てのクエリにまとめて答えます。
+ */
+template <typename EdgeType>
+std::vector<vertex_t> lowest_common_ancestor_offline(
+	vertex_t root,
+	const adjacency_list<EdgeType>& g,
+	const std::vector<std::pair<vertex_t, vertex_t>>& queries)
+{
+	const auto n = g.size();
+	const auto q = queries.size();
+	// queries grouped by vertex
+	std::vector<size_t> offsets(n + 1, 0);
+	for(const auto& p : queries){
+		++offsets[p.first + 1];
+		++offsets[p.second + 1];
+	}
+	for(vertex_t v = 0; v < n; ++v){ offsets[v + 1] += offsets[v]; }
+	std::vector<std::pair<vertex_t, size_t>> grouped(offsets[n]);
+	{
+		std::vector<size_t> heads(offsets.begin(), offsets.end() - 1);
+		for(size_t i = 0; i < q; ++i){
+			const auto& p = queries[i];
+			grouped[heads[p.first]++] = std::make_pair(p.second, i);
+			grouped[heads[p.second]++] = std::make_pair(p.first, i);
+		}
+	}
+
+	std::vector<vertex_t> result(q, n);
+	disjoint_set dset(n);
+	std::vector<vertex_t> ancestors(n, n);
+	std::vector<bool> finished(n, false);
+	std::vector<std::pair<vertex_t, size_t>> stack;
+	std::vector<vertex_t> parents(n, n);
+	stack.emplace_back(root, 0);
+	ancestors[root] = root;
+	while(!stack.empty()){
+		const auto u = stack.back().first;
+		auto& i = stack.back().second;
+		if(i < g[u].size()){
+			const auto v = g[u][i++].to;
+			if(v == parents[u]){ continue; }
+			parents[v] = u;
+			ancestors[v] = v;
+			stack.emplace_back(v, 0);
+			continue;
+		}
+		stack.pop_back();
+		finished[u] = true;
+		for(size_t k = offsets[u]; k < offsets[u + 1]; ++k){
+			const auto w = grouped[k].first;
+			if(finished[w]){
+				result[grouped[k].second] = ancestors[dset.find(w)];
+			}
+		}
+		if(!stack.empty()){
+			const auto p = stack.back().first;
+			ancestors[dset.unite(p, u)] = p;
+		}
+	}
+	return result;
+}
+
+}
@@ -0,0 +1,157 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+#include <utility>
+#include "loquat/graph/adjacency_list.hpp"
+#include "loquat/graph/breadth_first_search.hpp"
+#include "loquat/graph/euler_tour_technique.hpp"
+#include "loquat/math/bitmanip.hpp"
+
+namespace loquat {
+
+/**
+ * @brief 区間最小値クエリへの帰着による最小共通祖先。
+ *
+ * 行きがけ順で隣り合う区間 (pre(a), pre(b)] のうち最も浅い頂点の親が a と b の最小共通祖先となることを利用します。
+ * 区間最小値は 64 要素ごとのブロックに対するスパーステーブルと、ブロック内のビットマスクで求めます。
+ * 前計算の時間とメモリは O(N)、クエリは O(1) です。
+ */
+class lowest_common_ancestor_rmq {
+
+private:
+	static const size_t block_size = 64;
+
+	std::vector<size_t> m_depth;
+	std::vector<size_t> m_positions;
+	std::vector<size_t> m_keys;
+	std::vector<vertex_t> m_parents;
+	std::vector<uint64_t> m_masks;
+	std::vector<std::vector<size_t>> m_sparse_table;
+
+	size_t select(size_t i, size_t j) const {
+		return m_keys[j] < m_keys[i] ? j : i;
+	}
+
+	size_t block_argmin(size_t l, size_t r) const {
+		const auto offset = l % block_size;
+		const auto mask = m_masks[r] & (~uint64_t(0) << offset);
+		return r - r % block_size + bitmanip::ctz(mask);
+	}
+
+	size_t argmin(size_t l, size_t r) const {
+		const auto bl = l / block_size, br = r / block_size;
+		if(bl == br){ return block_argmin(l, r); }
+		auto result = select(
+			block_argmin(l, bl * block_size + block_size - 1),
+			block_argmin(br * block_size, r));
+		if(bl + 1 < br){
+			const auto x = bl + 1, y = br - 1;
+			const auto k = 63u - bitmanip::clz(uint64_t(y - x + 1));
+			const auto& row = m_sparse_table[k];
+			result = select(result, select(row[x], row[y + 1 - (size_t(1) << k)]));
+		}
+		return result;
+	}
+
+	void build_masks(){
+		const auto n = m_keys.size();
+		m_masks.assign(n, 0);
+		for(size_t start = 0; start < n; start += block_size){
+			uint64_t stack = 0;
+			const auto last = std::min(n, start + block_size);
+			for(size_t i = start; i < last; ++i){
+				while(stack != 0){
+					const auto top = 63u - bitmanip::clz(stack);
+					if(m_keys[start + top] <= m_keys[i]){ break; }
+					stack ^= uint64_t(1) << top;
+				}
+				stack |= uint64_t(1) << (i - start);
+				m_masks[i] = stack;
+			}
+		}
+	}
+
+	void build_sparse_table(){
+		const auto n = m_keys.size();
+		const auto num_blocks = (n + block_size - 1) / block_size;
+		if(num_blocks == 0){ return; }
+		std::vector<size_t> first(num_blocks);
+		for(size_t b = 0; b < num_blocks; ++b){
+			const auto last = std::min(n, (b + 1) * block_size) - 1;
+			first[b] = block_argmin(b * block_size, last);
+		}
+		m_sparse_table.push_back(std::move(first));
+		for(size_t k = 1; (size_t(1) << k) <= num_blocks; ++k){
+			const auto& prev = m_sparse_table.back();
+			const auto half = size_t(1) << (k - 1);
+			std::vector<size_t> next(num_blocks - (size_t(1) << k) + 1);
+			for(size_t b = 0; b < next.size(); ++b){
+				next[b] = select(prev[b], prev[b + half]);
+			}
+			m_sparse_table.push_back(std::move(next));
+		}
+	}
+
+public:
+	lowest_common_ancestor_rmq()
+		: m_depth()
+		, m_positions()
+		, m_keys()
+		, m_parents()
+		, m_masks()
+		, m_sparse_table()
+	{ }
+
+	template <typename EdgeType>
+	lowest_common_ancestor_rmq(vertex_t root, const adjacency_list<EdgeType>& g)
+		: m_depth(g.size())
+		, m_positions(g.size())
+		, m_keys(g.size())
+		, m_parents(g.size(), g.size())
+		, m_masks()
+		, m_sparse_table()
+	{
+		const size_t n = g.size();
+		std::vector<vertex_t> parents(n, n);
+		breadth_first_search(
+			g, root,
+			[this, &parents](vertex_t u, const EdgeType& e){
+				m_depth[e.to] = m_depth[u] + 1;
+				parents[e.to] = u;
+			});
+		{	// pre-order from the entering times of the euler tour
+			const auto tour = euler_tour_technique(root, g);
+			std::vector<vertex_t> by_time(2 * n, n);
+			for(vertex_t v = 0; v < n; ++v){ by_time[tour[v].in] = v; }
+			size_t k = 0;
+			for(const auto v : by_time){
+				if(v == n){ continue; }
+				m_positions[v] = k;
+				m_keys[k] = m_depth[v];
+				m_parents[k] = parents[v];
+				++k;
+			}
+		}
+		build_masks();
+		build_sparse_table();
+	}
+
+	size_t size() const {
+		return m_depth.size();
+	}
+
+	size_t depth(vertex_t v) const {
+		return m_depth[v];
+	}
+
+	vertex_t query(vertex_t a, vertex_t b) const {
+		if(a == b){ return a; }
+		auto l = m_positions[a], r = m_positions[b];
+		if(l > r){ std::swap(l, r); }
+		return m_parents[argmin(l + 1, r)];
+	}
+
+};
+
+}
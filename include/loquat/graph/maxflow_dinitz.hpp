@@ -1,6 +1,7 @@
 #pragma once
 #include <vector>
-#include <queue>
+#include <algorithm>
+#include <type_traits>
 #include "loquat/graph/adjacency_list.hpp"
 #include "loquat/math/infinity.hpp"
 
@@ -20,82 +21,172 @@ private:
 	adjacency_list<edge_type>& m_graph;
 	std::vector<size_t> m_levels;
 	std::vector<size_t> m_iterations;
+	std::vector<vertex_t> m_queue;
+	std::vector<vertex_t> m_path;
 	vertex_t m_source;
 	vertex_t m_sink;
+	capacity_type m_limit;
 
 	maxflow_dinitz_impl() = delete;
 	maxflow_dinitz_impl(const maxflow_dinitz_impl&) = delete;
 
-	explicit maxflow_dinitz_impl(
-		vertex_t source,
-		vertex_t sink,
-		adjacency_list<edge_type>& graph)
-		: m_graph(graph)
-		, m_levels()
-		, m_iterations()
-		, m_source(source)
-		, m_sink(sink)
-	{ }
-
-	std::vector<size_t> compute_level_map(vertex_t source) const {
-		const auto n = m_graph.size();
-		std::vector<size_t> levels(n, 0);
-		std::queue<vertex_t> q;
-		levels[source] = 1;
-		q.push(source);
-		while(!q.empty()){
-			const auto u = q.front();
-			q.pop();
+	static bool is_usable(const edge_type& e, capacity_type delta){
+		return e.capacity > 0 && !(e.capacity < delta);
+	}
+
+	// levels and iterations are nonzero only for the vertices in m_queue
+	void reset_levels(){
+		for(const auto v : m_queue){
+			m_levels[v] = 0;
+			m_iterations[v] = 0;
+		}
+		m_queue.clear();
+	}
+
+	bool compute_level_map(capacity_type delta){
+		reset_levels();
+		m_levels[m_source] = 1;
+		m_queue.push_back(m_source);
+		for(size_t head = 0; head < m_queue.size(); ++head){
+			const auto u = m_queue[head];
+			if(u == m_sink){ break; }
 			for(const auto& e : m_graph[u]){
 				const auto v = e.to;
-				if(e.capacity <= 0 || levels[v] != 0){ continue; }
-				levels[v] = levels[u] + 1;
-				q.push(v);
+				if(!is_usable(e, delta) || m_levels[v] != 0){ continue; }
+				m_levels[v] = m_levels[u] + 1;
+				m_queue.push_back(v);
 			}
 		}
-		return levels;
+		return m_levels[m_sink] != 0;
 	}
 
-	capacity_type dfs_recur(vertex_t u, capacity_type limit){
-		if(u == m_sink){ return limit; }
-		for(; m_iterations[u] < m_graph[u].size(); ++m_iterations[u]){
-			auto& e = m_graph[u][m_iterations[u]];
-			const auto v = e.to;
-			if(e.capacity <= 0 || m_levels[u] >= m_levels[v]){ continue; }
-			const auto diff = dfs_recur(v, std::min(e.capacity, limit));
-			if(diff > 0){
-				e.capacity -= diff;
-				m_graph[v][e.rev].capacity += diff;
-				return diff;
+	capacity_type blocking_flow(capacity_type delta, capacity_type limit){
+		capacity_type flow = 0;
+		m_path.clear();
+		m_path.push_back(m_source);
+		while(!m_path.empty() && flow < limit){
+			const auto u = m_path.back();
+			if(u == m_sink){
+				const auto k = m_path.size() - 1;
+				auto f = std::min(
+					limit - flow,
+					m_graph[m_path[0]][m_iterations[m_path[0]]].capacity);
+				for(size_t i = 1; i < k; ++i){
+					const auto& e = m_graph[m_path[i]][m_iterations[m_path[i]]];
+					f = std::min(f, e.capacity);
+				}
+				size_t retreat = k;
+				for(size_t i = 0; i < k; ++i){
+					auto& e = m_graph[m_path[i]][m_iterations[m_path[i]]];
+					e.capacity -= f;
+					m_graph[e.to][e.rev].capacity += f;
+					if(retreat == k && !is_usable(e, delta)){ retreat = i; }
+				}
+				flow += f;
+				m_path.resize(retreat + 1);
+				continue;
+			}
+			const auto& edges = m_graph[u];
+			auto& it = m_iterations[u];
+			while(it < edges.size()){
+				const auto& e = edges[it];
+				if(is_usable(e, delta) && m_levels[e.to] == m_levels[u] + 1){
+					break;
+				}
+				++it;
+			}
+			if(it < edges.size()){
+				m_path.push_back(edges[it].to);
+			}else{
+				m_levels[u] = 0;
+				m_path.pop_back();
+				if(!m_path.empty()){ ++m_iterations[m_path.back()]; }
 			}
 		}
-		return 0;
+		return flow;
 	}
 
-	capacity_type solve(){
-		const auto inf = positive_infinity<capacity_type>();
-		const auto n = m_graph.size();
+	capacity_type run_phases(capacity_type delta){
 		capacity_type flow = 0;
-		while(true){
-			m_levels = compute_level_map(m_source);
-			if(m_levels[m_sink] == 0){ break; }
-			m_iterations.assign(n, 0);
-			while(true){
-				const auto f = dfs_recur(m_source, inf);
-				if(f <= 0){ break; }
-				flow += f;
-			}
+		while(flow < m_limit && compute_level_map(delta)){
+			flow += blocking_flow(delta, m_limit - flow);
+		}
+		return flow;
+	}
+
+	capacity_type solve_scaling(vertex_t source, vertex_t sink){
+		m_source = source;
+		m_sink = sink;
+		m_limit = positive_infinity<capacity_type>();
+		if(m_source == m_sink){ return 0; }
+		capacity_type max_capacity = 0;
+		for(const auto& e : m_graph[m_source]){
+			max_capacity = std::max(max_capacity, e.capacity);
+		}
+		capacity_type delta = 1;
+		while(delta <= max_capacity / 2){ delta *= 2; }
+		capacity_type flow = 0;
+		for(; delta > 0; delta /= 2){
+			flow += run_phases(delta);
 		}
 		return flow;
 	}
 
 
 public:
+	/**
+	 * @brief graph を対象とする作業領域を確保します。
+	 *
+	 * 作業領域は複数回の push で使い回せます。各フェーズでは直前のフェーズで
+	 * 訪れた頂点の情報のみを初期化するため、頂点数に比例する初期化は構築時の一度だけです。
+	 */
+	explicit maxflow_dinitz_impl(adjacency_list<edge_type>& graph)
+		: m_graph(graph)
+		, m_levels(graph.size(), 0)
+		, m_iterations(graph.size(), 0)
+		, m_queue()
+		, m_path()
+		, m_source(0)
+		, m_sink(0)
+		, m_limit(0)
+	{
+		m_queue.reserve(graph.size());
+		m_path.reserve(graph.size());
+	}
+
+	/**
+	 * @brief 現在の残余ネットワーク上で source から sink へ最大 limit だけ流し、流した量を返します。
+	 */
+	capacity_type push(vertex_t source, vertex_t sink, capacity_type limit){
+		m_source = source;
+		m_sink = sink;
+		m_limit = limit;
+		if(m_source == m_sink){ return 0; }
+		return run_phases(0);
+	}
+
 	static capacity_type solve(
 		vertex_t source, vertex_t sink, adjacency_list<EdgeType>& graph)
 	{
-		maxflow_dinitz_impl<edge_type> self(source, sink, graph);
-		return self.solve();
+		maxflow_dinitz_impl<edge_type> self(graph);
+		return self.push(source, sink, positive_infinity<capacity_type>());
+	}
+
+	static capacity_type solve_limited(
+		vertex_t source,
+		vertex_t sink,
+		adjacency_list<EdgeType>& graph,
+		capacity_type limit)
+	{
+		maxflow_dinitz_impl<edge_type> self(graph);
+		return self.push(source, sink, limit);
+	}
+
+	static capacity_type solve_scaling(
+		vertex_t source, vertex_t sink, adjacency_list<EdgeType>& graph)
+	{
+		maxflow_dinitz_impl<edge_type> self(graph);
+		return self.solve_scaling(source, sink);
 	}
 
 };
@@ -114,5 +205,25 @@ maxflow_dinitz(
 	return detail::maxflow_dinitz_impl<edge_type>::solve(source, sink, graph);
 }
 
+/**
+ * @brief 容量スケーリングを併用する Dinitz 法による最大流。
+ *
+ * 残余容量が Δ 以上の辺のみを用いて Dinitz 法を行い、Δ を半分にしながら繰り返します。
+ * 容量は整数型でなければなりません。
+ */
+template <typename EdgeType>
+typename EdgeType::capacity_type
+maxflow_dinitz_scaling(
+	vertex_t source,
+	vertex_t sink,
+	adjacency_list<EdgeType>& graph)
+{
+	using edge_type = EdgeType;
+	static_assert(
+		std::is_integral<typename edge_type::capacity_type>::value,
+		"capacity scaling requires integral capacities");
+	return detail::maxflow_dinitz_impl<edge_type>::solve_scaling(
+		source, sink, graph);
 }
 
+}
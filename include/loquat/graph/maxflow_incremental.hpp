@@ -0,0 +1,121 @@
+#pragma once
+#include "loquat/graph/adjacency_list.hpp"
+#include "loquat/graph/maxflow_dinitz.hpp"
+
+namespace loquat {
+
+/**
+ * @brief 容量の変更に追従する最大流。
+ *
+ * loquat::make_residual で生成した残余ネットワーク上の最大流を保持し、
+ * 辺の容量が変更されたときは流れを差分だけ修正します。
+ * 容量が減少して流量を下回った場合は、超過分を別経路へ迂回させ、
+ * 迂回できなかった分を始点・終点へ押し戻してから増加路を探します。
+ * Dinitz 法の作業領域は構築時に一度だけ確保し、各更新では探索で訪れた頂点の情報のみを初期化します。
+ * 構築後にグラフへ頂点を追加してはいけません。
+ */
+template <typename EdgeType>
+class incremental_maxflow {
+
+public:
+	using edge_type = EdgeType;
+	using capacity_type = typename edge_type::capacity_type;
+
+
+private:
+	using impl_type = detail::maxflow_dinitz_impl<edge_type>;
+
+	adjacency_list<edge_type>& m_graph;
+	impl_type m_impl;
+	vertex_t m_source;
+	vertex_t m_sink;
+	capacity_type m_flow;
+
+	capacity_type push(vertex_t from, vertex_t to, capacity_type limit){
+		if(from == to || limit <= 0){ return 0; }
+		const auto f = m_impl.push(from, to, limit);
+		if(from == m_sink){ m_flow -= f; }
+		if(to == m_sink){ m_flow += f; }
+		return f;
+	}
+
+	void augment(){
+		m_flow += push(m_source, m_sink, positive_infinity<capacity_type>());
+	}
+
+
+public:
+	incremental_maxflow() = delete;
+	incremental_maxflow(const incremental_maxflow&) = delete;
+
+	/**
+	 * @param graph 残余ネットワーク。既に流れが流れている場合は flow にその流量を渡します。
+	 */
+	incremental_maxflow(
+		vertex_t source,
+		vertex_t sink,
+		adjacency_list<edge_type>& graph,
+		capacity_type flow = 0)
+		: m_graph(graph)
+		, m_impl(graph)
+		, m_source(source)
+		, m_sink(sink)
+		, m_flow(flow)
+	{
+		if(m_source != m_sink){ augment(); }
+	}
+
+
+	capacity_type flow() const {
+		return m_flow;
+	}
+
+	const adjacency_list<edge_type>& graph() const {
+		return m_graph;
+	}
+
+	/**
+	 * @brief 辺 graph[u][k] の元の容量を返します。
+	 */
+	capacity_type capacity(vertex_t u, size_t k) const {
+		const auto& e = m_graph[u][k];
+		return e.capacity + m_graph[e.to][e.rev].capacity;
+	}
+
+	/**
+	 * @brief 辺 graph[u][k] の容量を c に変更し、変更後の最大流量を返します。
+	 */
+	capacity_type update_capacity(vertex_t u, size_t k, capacity_type c){
+		auto& e = m_graph[u][k];
+		const auto v = e.to;
+		auto& r = m_graph[v][e.rev];
+		const auto f = r.capacity;
+		if(f <= c){
+			const bool increased = e.capacity + f < c;
+			e.capacity = c - f;
+			if(increased && m_source != m_sink){ augment(); }
+			return m_flow;
+		}
+		const auto excess = f - c;
+		e.capacity = 0;
+		r.capacity = c;
+		if(u == v || m_source == m_sink){ return m_flow; }
+		if(u == m_sink){ m_flow += excess; }
+		if(v == m_sink){ m_flow -= excess; }
+		const auto rerouted = push(u, v, excess);
+		const auto rest = excess - rerouted;
+		if(u != m_source && u != m_sink){
+			const auto f_source = push(u, m_source, rest);
+			push(u, m_sink, rest - f_source);
+		}
+		if(v != m_source && v != m_sink){
+			const auto f_sink = push(m_sink, v, rest);
+			push(m_source, v, rest - f_sink);
+		}
+		augment();
+		return m_flow;
+	}
+
+};
+
+}
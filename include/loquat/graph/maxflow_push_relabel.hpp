@@ -0,0 +1,262 @@
+#pragma once
+#include <vector>
+#include <queue>
+#include <limits>
+#include <algorithm>
+#include "loquat/graph/adjacency_list.hpp"
+
+namespace loquat {
+
+namespace detail {
+
+template <typename EdgeType>
+class maxflow_push_relabel_impl {
+
+public:
+	using edge_type = EdgeType;
+	using capacity_type = typename edge_type::capacity_type;
+
+
+private:
+	adjacency_list<edge_type>& m_graph;
+	vertex_t m_source;
+	vertex_t m_sink;
+	vertex_t m_target;
+	vertex_t m_fixed;
+
+	std::vector<size_t> m_heights;
+	std::vector<capacity_type> m_excess;
+	std::vector<size_t> m_current;
+
+	std::vector<vertex_t> m_active_head;
+	std::vector<vertex_t> m_active_next;
+	std::vector<vertex_t> m_all_head;
+	std::vector<vertex_t> m_all_next;
+	std::vector<vertex_t> m_all_prev;
+	size_t m_max_active;
+	size_t m_max_height;
+	size_t m_relabel_count;
+
+	maxflow_push_relabel_impl() = delete;
+	maxflow_push_relabel_impl(const maxflow_push_relabel_impl&) = delete;
+
+	explicit maxflow_push_relabel_impl(
+		vertex_t source,
+		vertex_t sink,
+		adjacency_list<edge_type>& graph)
+		: m_graph(graph)
+		, m_source(source)
+		, m_sink(sink)
+		, m_target(sink)
+		, m_fixed(source)
+		, m_heights(graph.size())
+		, m_excess(graph.size())
+		, m_current(graph.size())
+		, m_active_head(graph.size())
+		, m_active_next(graph.size())
+		, m_all_head(graph.size())
+		, m_all_next(graph.size())
+		, m_all_prev(graph.size())
+		, m_max_active(0)
+		, m_max_height(0)
+		, m_relabel_count(0)
+	{ }
+
+
+	vertex_t nil() const {
+		return m_graph.size();
+	}
+
+	bool is_active(vertex_t v) const {
+		return v != m_target && v != m_fixed && m_excess[v] > 0;
+	}
+
+	void push_active(vertex_t v){
+		const auto h = m_heights[v];
+		m_active_next[v] = m_active_head[h];
+		m_active_head[h] = v;
+		m_max_active = std::max(m_max_active, h);
+	}
+
+	void insert_all(vertex_t v){
+		const auto h = m_heights[v];
+		m_all_prev[v] = nil();
+		m_all_next[v] = m_all_head[h];
+		if(m_all_head[h] != nil()){ m_all_prev[m_all_head[h]] = v; }
+		m_all_head[h] = v;
+		m_max_height = std::max(m_max_height, h);
+	}
+
+	void erase_all(vertex_t v){
+		const auto h = m_heights[v];
+		if(m_all_prev[v] != nil()){
+			m_all_next[m_all_prev[v]] = m_all_next[v];
+		}else{
+			m_all_head[h] = m_all_next[v];
+		}
+		if(m_all_next[v] != nil()){
+			m_all_prev[m_all_next[v]] = m_all_prev[v];
+		}
+	}
+
+	void global_relabel(){
+		const auto n = m_graph.size();
+		std::fill(m_heights.begin(), m_heights.end(), n);
+		std::fill(m_active_head.begin(), m_active_head.end(), nil());
+		std::fill(m_all_head.begin(), m_all_head.end(), nil());
+		std::fill(m_current.begin(), m_current.end(), 0);
+		m_max_active = 0;
+		m_max_height = 0;
+		m_relabel_count = 0;
+		std::queue<vertex_t> q;
+		m_heights[m_target] = 0;
+		q.push(m_target);
+		while(!q.empty()){
+			const auto v = q.front();
+			q.pop();
+			for(const auto& e : m_graph[v]){
+				const auto u = e.to;
+				if(u == m_fixed || m_heights[u] != n){ continue; }
+				if(m_graph[u][e.rev].capacity <= 0){ continue; }
+				m_heights[u] = m_heights[v] + 1;
+				q.push(u);
+			}
+		}
+		for(vertex_t v = 0; v < n; ++v){
+			if(m_heights[v] >= n){ continue; }
+			insert_all(v);
+			if(is_active(v)){ push_active(v); }
+		}
+	}
+
+	void gap(size_t k){
+		const auto n = m_graph.size();
+		for(size_t h = k; h <= m_max_height; ++h){
+			for(vertex_t v = m_all_head[h]; v != nil(); v = m_all_next[v]){
+				m_heights[v] = n;
+			}
+			m_all_head[h] = nil();
+			m_active_head[h] = nil();
+		}
+		m_max_height = (k > 0 ? k - 1 : 0);
+		m_max_active = std::min(m_max_active, m_max_height);
+	}
+
+	void relabel(vertex_t u){
+		const auto n = m_graph.size();
+		const auto old_height = m_heights[u];
+		++m_relabel_count;
+		erase_all(u);
+		if(m_all_head[old_height] == nil()){
+			m_heights[u] = n;
+			gap(old_height);
+			return;
+		}
+		size_t next_height = n;
+		const auto& edges = m_graph[u];
+		for(size_t i = 0; i < edges.size(); ++i){
+			const auto& e = edges[i];
+			if(e.capacity <= 0){ continue; }
+			if(m_heights[e.to] + 1 < next_height){
+				next_height = m_heights[e.to] + 1;
+				m_current[u] = i;
+			}
+		}
+		m_heights[u] = next_height;
+		if(next_height < n){ insert_all(u); }
+	}
+
+	void discharge(vertex_t u){
+		const auto n = m_graph.size();
+		auto& edges = m_graph[u];
+		while(m_excess[u] > 0){
+			if(m_current[u] == edges.size()){
+				relabel(u);
+				if(m_heights[u] >= n){ break; }
+				continue;
+			}
+			auto& e = edges[m_current[u]];
+			const auto v = e.to;
+			if(e.capacity > 0 && m_heights[u] == m_heights[v] + 1){
+				const auto f = std::min(m_excess[u], e.capacity);
+				const bool was_active = is_active(v);
+				e.capacity -= f;
+				m_graph[v][e.rev].capacity += f;
+				m_excess[u] -= f;
+				m_excess[v] += f;
+				if(!was_active && is_active(v)){ push_active(v); }
+			}else{
+				++m_current[u];
+			}
+		}
+	}
+
+	void run(){
+		const auto n = m_graph.size();
+		global_relabel();
+		while(true){
+			while(m_max_active > 0 && m_active_head[m_max_active] == nil()){
+				--m_max_active;
+			}
+			if(m_max_active == 0){ break; }
+			const auto u = m_active_head[m_max_active];
+			m_active_head[m_max_active] = m_active_next[u];
+			if(m_heights[u] != m_max_active || !is_active(u)){ continue; }
+			discharge(u);
+			if(m_relabel_count >= n){ global_relabel(); }
+		}
+	}
+
+	capacity_type solve(){
+		if(m_source == m_sink){ return capacity_type(); }
+		for(auto& e : m_graph[m_source]){
+			if(e.capacity <= 0){ continue; }
+			const auto f = e.capacity;
+			e.capacity -= f;
+			m_graph[e.to][e.rev].capacity += f;
+			m_excess[e.to] += f;
+			m_excess[m_source] -= f;
+		}
+		m_target = m_sink;
+		m_fixed = m_source;
+		run();
+		m_target = m_source;
+		m_fixed = m_sink;
+		run();
+		return m_excess[m_sink];
+	}
+
+
+public:
+	static capacity_type solve(
+		vertex_t source, vertex_t sink, adjacency_list<EdgeType>& graph)
+	{
+		maxflow_push_relabel_impl<edge_type> self(source, sink, graph);
+		return self.solve();
+	}
+
+};
+
+}
+
+
+/**
+ * @brief 最高ラベル選択のプッシュ・再ラベル法による最大流。
+ *
+ * ギャップ・ヒューリスティックと定期的な大域再ラベルを用います。
+ * 最大プリフローを求めた後、残った超過分を始点へ戻して実行可能な流れに変換します。
+ * graph は loquat::make_residual で生成した残余ネットワークで、計算後の残余容量が書き込まれます。
+ */
+template <typename EdgeType>
+typename EdgeType::capacity_type
+maxflow_push_relabel(
+	vertex_t source,
+	vertex_t sink,
+	adjacency_list<EdgeType>& graph)
+{
+	using edge_type = EdgeType;
+	return detail::maxflow_push_relabel_impl<edge_type>::solve(
+		source, sink, graph);
+}
+
+}
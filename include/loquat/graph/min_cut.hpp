@@ -0,0 +1,82 @@
+#pragma once
+#include <vector>
+#include <queue>
+#include <utility>
+#include "loquat/graph/adjacency_list.hpp"
+
+namespace loquat {
+
+/**
+ * @brief 最小カットの情報。
+ */
+template <typename CapacityType>
+struct min_cut_result {
+	/// カットの容量
+	CapacityType capacity;
+	/// 各頂点が始点側に属するかどうか
+	std::vector<bool> source_side;
+	/// 始点側から終点側へ向かう辺 graph[u][i] の組 (u, i) のリスト
+	std::vector<std::pair<vertex_t, size_t>> edges;
+};
+
+
+/**
+ * @brief 最大流を流した後の残余ネットワークから最小カットの始点側を求める。
+ * @return 始点から残余容量が正の辺のみを通って到達可能な頂点の集合。
+ */
+template <typename EdgeType>
+std::vector<bool> min_cut_source_side(
+	vertex_t source,
+	const adjacency_list<EdgeType>& residual)
+{
+	const auto n = residual.size();
+	std::vector<bool> result(n, false);
+	std::queue<vertex_t> q;
+	result[source] = true;
+	q.push(source);
+	while(!q.empty()){
+		const auto u = q.front();
+		q.pop();
+		for(const auto& e : residual[u]){
+			const auto v = e.to;
+			if(result[v] || e.capacity <= 0){ continue; }
+			result[v] = true;
+			q.push(v);
+		}
+	}
+	return result;
+}
+
+/**
+ * @brief 最大流を流した後の残余ネットワークから最小カットを求める。
+ * @param residual 最大流を流した後の残余ネットワーク。
+ * @param graph    residual の生成元となったグラフ。
+ *
+ * graph に含まれる辺のうち、始点側から終点側へ向かう容量が正の辺をカット辺として列挙します。
+ */
+template <typename ResidualEdgeType, typename EdgeType>
+min_cut_result<typename EdgeType::capacity_type>
+min_cut(
+	vertex_t source,
+	const adjacency_list<ResidualEdgeType>& residual,
+	const adjacency_list<EdgeType>& graph)
+{
+	using capacity_type = typename EdgeType::capacity_type;
+	const auto n = graph.size();
+	min_cut_result<capacity_type> result;
+	result.capacity = capacity_type();
+	result.source_side = min_cut_source_side(source, residual);
+	const auto& side = result.source_side;
+	for(vertex_t u = 0; u < n; ++u){
+		if(!side[u]){ continue; }
+		for(size_t i = 0; i < graph[u].size(); ++i){
+			const auto& e = graph[u][i];
+			if(side[e.to] || e.capacity <= 0){ continue; }
+			result.capacity += e.capacity;
+			result.edges.emplace_back(u, i);
+		}
+	}
+	return result;
+}
+
+}
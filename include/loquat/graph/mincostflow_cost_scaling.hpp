@@ -0,0 +1,179 @@
+#pragma once
+#include <vector>
+#include <queue>
+#include <algorithm>
+#include <type_traits>
+#include "loquat/graph/adjacency_list.hpp"
+#include "loquat/graph/maxflow_dinitz.hpp"
+#include "loquat/misc/exceptions.hpp"
+
+namespace loquat {
+
+namespace detail {
+
+template <typename EdgeType>
+class mincostflow_cost_scaling_impl {
+
+public:
+	using edge_type = EdgeType;
+	using weight_type = typename edge_type::weight_type;
+	using capacity_type = typename edge_type::capacity_type;
+
+
+private:
+	adjacency_list<edge_type>& m_graph;
+	weight_type m_scale;
+	std::vector<weight_type> m_potentials;
+	std::vector<capacity_type> m_excess;
+	std::vector<size_t> m_current;
+	std::queue<vertex_t> m_queue;
+
+	mincostflow_cost_scaling_impl() = delete;
+	mincostflow_cost_scaling_impl(const mincostflow_cost_scaling_impl&) = delete;
+
+	explicit mincostflow_cost_scaling_impl(adjacency_list<edge_type>& graph)
+		: m_graph(graph)
+		, m_scale(static_cast<weight_type>(graph.size() + 1))
+		, m_potentials(graph.size())
+		, m_excess(graph.size())
+		, m_current(graph.size())
+		, m_queue()
+	{ }
+
+	weight_type reduced_cost(vertex_t u, const edge_type& e) const {
+		return e.weight * m_scale + m_potentials[u] - m_potentials[e.to];
+	}
+
+	void push(vertex_t u, edge_type& e, capacity_type f){
+		const auto v = e.to;
+		const bool was_active = m_excess[v] > 0;
+		e.capacity -= f;
+		m_graph[v][e.rev].capacity += f;
+		m_excess[u] -= f;
+		m_excess[v] += f;
+		if(!was_active && m_excess[v] > 0){ m_queue.push(v); }
+	}
+
+	void relabel(vertex_t u, weight_type eps){
+		bool found = false;
+		weight_type next = weight_type();
+		for(const auto& e : m_graph[u]){
+			if(e.capacity <= 0){ continue; }
+			const auto x = m_potentials[e.to] - e.weight * m_scale;
+			if(!found || next < x){
+				next = x;
+				found = true;
+			}
+		}
+		m_potentials[u] = next - eps;
+	}
+
+	void discharge(vertex_t u, weight_type eps){
+		auto& edges = m_graph[u];
+		while(m_excess[u] > 0){
+			if(m_current[u] == edges.size()){
+				relabel(u, eps);
+				m_current[u] = 0;
+				continue;
+			}
+			auto& e = edges[m_current[u]];
+			if(e.capacity > 0 && reduced_cost(u, e) < 0){
+				push(u, e, std::min(m_excess[u], e.capacity));
+			}else{
+				++m_current[u];
+			}
+		}
+	}
+
+	void refine(weight_type eps){
+		const auto n = m_graph.size();
+		for(vertex_t u = 0; u < n; ++u){
+			for(auto& e : m_graph[u]){
+				if(e.capacity > 0 && reduced_cost(u, e) < 0){
+					push(u, e, e.capacity);
+				}
+			}
+		}
+		std::fill(m_current.begin(), m_current.end(), 0);
+		while(!m_queue.empty()){
+			const auto u = m_queue.front();
+			m_queue.pop();
+			discharge(u, eps);
+		}
+	}
+
+	void solve(){
+		const weight_type alpha = 16;
+		const auto n = m_graph.size();
+		weight_type eps = 0;
+		for(vertex_t u = 0; u < n; ++u){
+			for(const auto& e : m_graph[u]){
+				if(e.capacity <= 0){ continue; }
+				const auto c = e.weight * m_scale;
+				eps = std::max(eps, c < 0 ? -c : c);
+			}
+		}
+		while(eps > 1){
+			eps = std::max<weight_type>(eps / alpha, 1);
+			refine(eps);
+		}
+	}
+
+
+public:
+	static void solve(adjacency_list<edge_type>& graph){
+		mincostflow_cost_scaling_impl<edge_type> self(graph);
+		self.solve();
+	}
+
+};
+
+}
+
+
+/**
+ * @brief コストスケーリング法による最小費用流。
+ *
+ * 始点から終点へ flow だけ流した後、ε-最適性を保つプッシュ・再ラベル法で負閉路を解消します。
+ * 重みは整数でなければならず、重みの絶対値と頂点数の積の数倍が weight_type に収まる必要があります。
+ * 負の重みを持つ辺や負閉路が存在していても最適解を求めます。
+ */
+template <typename EdgeType>
+typename EdgeType::weight_type
+mincostflow_cost_scaling(
+	typename EdgeType::capacity_type flow,
+	vertex_t source,
+	vertex_t sink,
+	adjacency_list<EdgeType>& graph)
+{
+	using edge_type = EdgeType;
+	using weight_type = typename edge_type::weight_type;
+	using capacity_type = typename edge_type::capacity_type;
+	static_assert(
+		std::is_integral<weight_type>::value,
+		"cost scaling requires integral weights");
+	const auto n = graph.size();
+	std::vector<capacity_type> initial;
+	for(vertex_t u = 0; u < n; ++u){
+		for(const auto& e : graph[u]){ initial.push_back(e.capacity); }
+	}
+	if(flow > 0){
+		const auto actual =
+			detail::maxflow_dinitz_impl<edge_type>::solve_limited(
+				source, sink, graph, flow);
+		if(actual < flow){
+			throw no_solution_error("there are no enough capacities to flow");
+		}
+	}
+	detail::mincostflow_cost_scaling_impl<edge_type>::solve(graph);
+	weight_type result = 0;
+	size_t k = 0;
+	for(vertex_t u = 0; u < n; ++u){
+		for(const auto& e : graph[u]){
+			result += (initial[k++] - e.capacity) * e.weight;
+		}
+	}
+	return result / 2;
+}
+
+}
@@ -0,0 +1,399 @@
+#pragma once
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include "loquat/graph/adjacency_list.hpp"
+#include "loquat/math/infinity.hpp"
+#include "loquat/misc/exceptions.hpp"
+
+namespace loquat {
+
+namespace detail {
+
+template <typename EdgeType>
+class mincostflow_network_simplex_impl {
+
+public:
+	using edge_type = EdgeType;
+	using weight_type = typename edge_type::weight_type;
+	using capacity_type = typename edge_type::capacity_type;
+
+
+private:
+	enum {
+		state_upper = -1,
+		state_tree  =  0,
+		state_lower =  1
+	};
+
+	adjacency_list<edge_type>& m_graph;
+	size_t m_num_vertices;
+	size_t m_num_real_arcs;
+	vertex_t m_root;
+
+	// arcs
+	std::vector<vertex_t> m_arc_source;
+	std::vector<vertex_t> m_arc_target;
+	std::vector<weight_type> m_arc_cost;
+	std::vector<capacity_type> m_arc_capacity;
+	std::vector<capacity_type> m_arc_flow;
+	std::vector<capacity_type> m_arc_initial;
+	std::vector<int> m_arc_state;
+	std::vector<std::pair<vertex_t, size_t>> m_arc_origin;
+
+	// spanning tree
+	std::vector<vertex_t> m_parent;
+	std::vector<size_t> m_pred;
+	std::vector<size_t> m_depth;
+	std::vector<weight_type> m_potential;
+	std::vector<vertex_t> m_first_child;
+	std::vector<vertex_t> m_next_sibling;
+	std::vector<vertex_t> m_prev_sibling;
+
+	std::vector<size_t> m_cycle;
+	std::vector<vertex_t> m_stack;
+	size_t m_next_arc;
+
+	mincostflow_network_simplex_impl() = delete;
+	mincostflow_network_simplex_impl(
+		const mincostflow_network_simplex_impl&) = delete;
+
+	explicit mincostflow_network_simplex_impl(adjacency_list<edge_type>& graph)
+		: m_graph(graph)
+		, m_num_vertices(graph.size())
+		, m_num_real_arcs(0)
+		, m_root(graph.size())
+		, m_arc_source()
+		, m_arc_target()
+		, m_arc_cost()
+		, m_arc_capacity()
+		, m_arc_flow()
+		, m_arc_initial()
+		, m_arc_state()
+		, m_arc_origin()
+		, m_parent(graph.size() + 1)
+		, m_pred(graph.size() + 1)
+		, m_depth(graph.size() + 1)
+		, m_potential(graph.size() + 1)
+		, m_first_child(graph.size() + 1)
+		, m_next_sibling(graph.size() + 1)
+		, m_prev_sibling(graph.size() + 1)
+		, m_cycle()
+		, m_stack()
+		, m_next_arc(0)
+	{ }
+
+
+	vertex_t nil() const {
+		return m_num_vertices + 1;
+	}
+
+	void add_arc(
+		vertex_t u, vertex_t v, weight_type cost,
+		capacity_type capacity, capacity_type flow)
+	{
+		m_arc_source.push_back(u);
+		m_arc_target.push_back(v);
+		m_arc_cost.push_back(cost);
+		m_arc_capacity.push_back(capacity);
+		m_arc_flow.push_back(flow);
+		m_arc_initial.push_back(flow);
+		m_arc_state.push_back(state_lower);
+	}
+
+	void attach(vertex_t v, vertex_t p){
+		m_parent[v] = p;
+		m_prev_sibling[v] = nil();
+		m_next_sibling[v] = m_first_child[p];
+		if(m_first_child[p] != nil()){ m_prev_sibling[m_first_child[p]] = v; }
+		m_first_child[p] = v;
+	}
+
+	void detach(vertex_t v){
+		const auto p = m_parent[v];
+		if(m_prev_sibling[v] != nil()){
+			m_next_sibling[m_prev_sibling[v]] = m_next_sibling[v];
+		}else{
+			m_first_child[p] = m_next_sibling[v];
+		}
+		if(m_next_sibling[v] != nil()){
+			m_prev_sibling[m_next_sibling[v]] = m_prev_sibling[v];
+		}
+	}
+
+	weight_type reduced_cost(size_t a) const {
+		return m_arc_cost[a]
+			+ m_potential[m_arc_source[a]] - m_potential[m_arc_target[a]];
+	}
+
+	bool is_violating(size_t a) const {
+		const auto state = m_arc_state[a];
+		if(state == state_tree){ return false; }
+		const auto rc = reduced_cost(a);
+		return state == state_lower ? rc < 0 : 0 < rc;
+	}
+
+	// block search pivot rule
+	size_t find_entering_arc(){
+		const auto m = m_arc_source.size();
+		const auto block_size = std::max<size_t>(
+			static_cast<size_t>(std::sqrt(static_cast<double>(m))), 10);
+		size_t best = m;
+		weight_type best_violation = 0;
+		size_t count = 0;
+		for(size_t i = 0; i < m; ++i){
+			const auto a = m_next_arc;
+			m_next_arc = (m_next_arc + 1 == m ? 0 : m_next_arc + 1);
+			if(is_violating(a)){
+				const auto rc = reduced_cost(a);
+				const auto violation = rc < 0 ? -rc : rc;
+				if(best == m || best_violation < violation){
+					best = a;
+					best_violation = violation;
+				}
+			}
+			if(++count == block_size){
+				if(best != m){ return best; }
+				count = 0;
+			}
+		}
+		return best;
+	}
+
+	capacity_type residual_capacity(size_t a, bool forward) const {
+		return forward ? m_arc_capacity[a] - m_arc_flow[a] : m_arc_flow[a];
+	}
+
+	void update_subtree(vertex_t r){
+		m_stack.clear();
+		m_stack.push_back(r);
+		while(!m_stack.empty()){
+			const auto v = m_stack.back();
+			m_stack.pop_back();
+			const auto p = m_parent[v];
+			const auto a = m_pred[v];
+			m_depth[v] = m_depth[p] + 1;
+			if(m_arc_source[a] == v){
+				m_potential[v] = m_potential[p] - m_arc_cost[a];
+			}else{
+				m_potential[v] = m_potential[p] + m_arc_cost[a];
+			}
+			for(auto c = m_first_child[v]; c != nil(); c = m_next_sibling[c]){
+				m_stack.push_back(c);
+			}
+		}
+	}
+
+	void pivot(size_t entering){
+		// the cycle is oriented along the direction of the flow change
+		vertex_t first, second;
+		if(m_arc_state[entering] == state_lower){
+			first = m_arc_source[entering];
+			second = m_arc_target[entering];
+		}else{
+			first = m_arc_target[entering];
+			second = m_arc_source[entering];
+		}
+		vertex_t x = first, y = second;
+		while(x != y){
+			if(m_depth[x] >= m_depth[y]){ x = m_parent[x]; }
+			else{ y = m_parent[y]; }
+		}
+		const auto join = x;
+
+		// enumerate the cycle from join: join -> first -> second -> join
+		m_cycle.clear();
+		for(vertex_t v = first; v != join; v = m_parent[v]){
+			m_cycle.push_back(v);
+		}
+		std::reverse(m_cycle.begin(), m_cycle.end());
+		const size_t first_side = m_cycle.size();
+		m_cycle.push_back(m_num_vertices + 1);
+		for(vertex_t v = second; v != join; v = m_parent[v]){
+			m_cycle.push_back(v);
+		}
+
+		// the last blocking arc keeps the tree strongly feasible
+		const auto entering_forward = (m_arc_state[entering] == state_lower);
+		capacity_type delta = residual_capacity(entering, entering_forward);
+		size_t leaving_index = first_side;
+		for(size_t i = 0; i < m_cycle.size(); ++i){
+			if(i == first_side){
+				if(residual_capacity(entering, entering_forward) <= delta){
+					leaving_index = i;
+				}
+				continue;
+			}
+			const auto v = m_cycle[i];
+			const auto a = m_pred[v];
+			// first side: flow goes parent -> v, second side: v -> parent
+			const bool toward_parent = (i > first_side);
+			const bool forward = (m_arc_source[a] == v) == toward_parent;
+			const auto r = residual_capacity(a, forward);
+			if(r <= delta){
+				delta = r;
+				leaving_index = i;
+			}
+		}
+
+		if(delta > 0){
+			m_arc_flow[entering] += entering_forward ? delta : -delta;
+			for(size_t i = 0; i < m_cycle.size(); ++i){
+				if(i == first_side){ continue; }
+				const auto v = m_cycle[i];
+				const auto a = m_pred[v];
+				const bool toward_parent = (i > first_side);
+				const bool forward = (m_arc_source[a] == v) == toward_parent;
+				m_arc_flow[a] += forward ? delta : -delta;
+			}
+		}
+
+		if(leaving_index == first_side){
+			m_arc_state[entering] = -m_arc_state[entering];
+			return;
+		}
+
+		const auto w = m_cycle[leaving_index];
+		const auto leaving = m_pred[w];
+		vertex_t u_in, v_in;
+		if(leaving_index < first_side){
+			u_in = first;
+			v_in = second;
+		}else{
+			u_in = second;
+			v_in = first;
+		}
+		m_arc_state[entering] = state_tree;
+		m_arc_state[leaving] =
+			(m_arc_flow[leaving] == 0) ? state_lower : state_upper;
+
+		// re-hang the subtree of w at u_in
+		vertex_t v = u_in, new_parent = v_in;
+		size_t new_pred = entering;
+		while(true){
+			const auto old_parent = m_parent[v];
+			const auto old_pred = m_pred[v];
+			detach(v);
+			attach(v, new_parent);
+			m_pred[v] = new_pred;
+			if(v == w){ break; }
+			new_parent = v;
+			new_pred = old_pred;
+			v = old_parent;
+		}
+		update_subtree(u_in);
+	}
+
+	void initialize(capacity_type flow, vertex_t source, vertex_t sink){
+		const auto n = m_num_vertices;
+		std::vector<capacity_type> supply(n + 1);
+		supply[source] += flow;
+		supply[sink] -= flow;
+		weight_type max_cost = 0;
+		for(vertex_t u = 0; u < n; ++u){
+			const auto& edges = m_graph[u];
+			for(size_t i = 0; i < edges.size(); ++i){
+				const auto& e = edges[i];
+				const auto v = e.to;
+				if(v < u || (v == u && e.rev < i)){ continue; }
+				const auto& r = m_graph[v][e.rev];
+				const auto capacity = e.capacity + r.capacity;
+				if(capacity <= 0){ continue; }
+				// the current flow is moved into the supplies
+				supply[u] += r.capacity;
+				supply[v] -= r.capacity;
+				add_arc(u, v, e.weight, capacity, r.capacity);
+				m_arc_origin.emplace_back(u, i);
+				m_arc_flow.back() = 0;
+				const auto c = (e.weight < 0 ? -e.weight : e.weight);
+				max_cost = std::max(max_cost, c);
+			}
+		}
+		m_num_real_arcs = m_arc_source.size();
+
+		const auto big_m =
+			max_cost * static_cast<weight_type>(n + 1) + weight_type(1);
+		const auto inf = positive_infinity<capacity_type>();
+		std::fill(m_first_child.begin(), m_first_child.end(), nil());
+		m_parent[m_root] = nil();
+		m_depth[m_root] = 0;
+		m_potential[m_root] = 0;
+		for(vertex_t v = 0; v < n; ++v){
+			const auto a = m_arc_source.size();
+			if(supply[v] >= 0){
+				add_arc(v, m_root, big_m, inf, supply[v]);
+				m_potential[v] = -big_m;
+			}else{
+				add_arc(m_root, v, big_m, inf, -supply[v]);
+				m_potential[v] = big_m;
+			}
+			m_arc_state[a] = state_tree;
+			m_pred[v] = a;
+			m_depth[v] = 1;
+			attach(v, m_root);
+		}
+	}
+
+	weight_type solve(capacity_type flow, vertex_t source, vertex_t sink){
+		initialize(flow, source, sink);
+		const auto m = m_arc_source.size();
+		while(true){
+			const auto entering = find_entering_arc();
+			if(entering == m){ break; }
+			pivot(entering);
+		}
+		for(size_t a = m_num_real_arcs; a < m; ++a){
+			if(m_arc_flow[a] > 0){
+				throw no_solution_error("there are no enough capacities to flow");
+			}
+		}
+		weight_type result = 0;
+		for(size_t a = 0; a < m_num_real_arcs; ++a){
+			const auto& origin = m_arc_origin[a];
+			auto& e = m_graph[origin.first][origin.second];
+			auto& r = m_graph[e.to][e.rev];
+			result += (m_arc_flow[a] - m_arc_initial[a]) * m_arc_cost[a];
+			e.capacity = m_arc_capacity[a] - m_arc_flow[a];
+			r.capacity = m_arc_flow[a];
+		}
+		return result;
+	}
+
+
+public:
+	static weight_type solve(
+		capacity_type flow,
+		vertex_t source,
+		vertex_t sink,
+		adjacency_list<edge_type>& graph)
+	{
+		mincostflow_network_simplex_impl<edge_type> self(graph);
+		return self.solve(flow, source, sink);
+	}
+
+};
+
+}
+
+
+/**
+ * @brief ネットワーク単体法による最小費用流。
+ *
+ * 人工頂点と重み Big-M の人工辺からなる初期基底から、ブロック探索による
+ * 枢軸選択で基底を更新します。強実行可能木を保つことで退化による巡回を防ぎます。
+ * 負の重みを持つ辺や負閉路が存在していても最適解を求めます。
+ */
+template <typename EdgeType>
+typename EdgeType::weight_type
+mincostflow_network_simplex(
+	typename EdgeType::capacity_type flow,
+	vertex_t source,
+	vertex_t sink,
+	adjacency_list<EdgeType>& graph)
+{
+	using edge_type = EdgeType;
+	return detail::mincostflow_network_simplex_impl<edge_type>::solve(
+		flow, source, sink, graph);
+}
+
+}
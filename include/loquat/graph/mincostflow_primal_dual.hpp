@@ -1,74 +1,267 @@
 #pragma once
 #include <vector>
-#include <queue>
+#include <utility>
+#include <algorithm>
+#include "loquat/container/indexed_d_ary_heap.hpp"
 #include "loquat/graph/adjacency_list.hpp"
-#include "loquat/graph/algorithms.hpp"
-#include "loquat/graph/sssp_bellman_ford.hpp"
+#include "loquat/graph/sssp_spfa.hpp"
+#include "loquat/math/infinity.hpp"
+#include "loquat/misc/exceptions.hpp"
 
 namespace loquat {
 
+/**
+ * @brief 主双対法による最小費用流のソルバ。
+ *
+ * 作業領域を保持し、同じネットワークに対して繰り返し流量を追加できます。
+ * ポテンシャルの初期値は容量が正の辺からなるグラフが DAG であれば動的計画法で、
+ * そうでなければ Bellman-Ford 法で求めます。
+ */
 template <typename EdgeType>
-typename EdgeType::weight_type
-mincostflow_primal_dual(
-	typename EdgeType::capacity_type flow,
-	vertex_t source,
-	vertex_t sink,
-	adjacency_list<EdgeType>& graph)
-{
+class mincostflow_primal_dual_solver {
+
+public:
 	using edge_type = EdgeType;
 	using weight_type = typename edge_type::weight_type;
-	const auto inf = positive_infinity<weight_type>();
-	const auto n = graph.size();
-	const auto predicate =
-		[](vertex_t, const edge_type& e) -> bool { return e.capacity > 0; };
-	auto h = sssp_bellman_ford(source, filter(graph, predicate));
-	std::vector<vertex_t> prev_vertex(n);
-	std::vector<size_t> prev_edge(n);
-	weight_type result = 0;
-	while(flow > 0){
-		using pair_type = std::pair<weight_type, vertex_t>;
-		std::priority_queue<
-			pair_type, std::vector<pair_type>, std::greater<pair_type>> pq;
-		std::vector<weight_type> d(n, inf);
-		pq.emplace(0, source);
-		d[source] = weight_type();
-		while(!pq.empty()){
-			const auto p = pq.top();
-			pq.pop();
-			const auto u = p.second;
-			if(d[u] < p.first){ continue; }
-			for(size_t i = 0; i < graph[u].size(); ++i){
-				const auto& e = graph[u][i];
-				if(e.capacity <= 0){ continue; }
+	using capacity_type = typename edge_type::capacity_type;
+	using breakpoint_type = std::pair<capacity_type, weight_type>;
+
+
+private:
+	adjacency_list<edge_type>& m_graph;
+	vertex_t m_source;
+	vertex_t m_sink;
+
+	std::vector<weight_type> m_potentials;
+	std::vector<weight_type> m_distances;
+	std::vector<vertex_t> m_prev_vertex;
+	std::vector<size_t> m_prev_edge;
+	std::vector<size_t> m_work;
+	indexed_d_ary_heap<weight_type> m_heap;
+
+	capacity_type m_flow;
+	weight_type m_cost;
+	std::vector<breakpoint_type> m_breakpoints;
+	// cost per unit flow of the last segment of m_breakpoints
+	weight_type m_last_unit_cost;
+
+	static bool is_residual(const edge_type& e){
+		return e.capacity > 0;
+	}
+
+	// topological order of the residual graph into m_prev_vertex
+	bool compute_topological_order(){
+		const auto n = m_graph.size();
+		auto& degrees = m_work;
+		auto& order = m_prev_vertex;
+		std::fill(degrees.begin(), degrees.end(), 0);
+		for(vertex_t u = 0; u < n; ++u){
+			for(const auto& e : m_graph[u]){
+				if(is_residual(e)){ ++degrees[e.to]; }
+			}
+		}
+		size_t tail = 0;
+		for(vertex_t v = 0; v < n; ++v){
+			if(degrees[v] == 0){ order[tail++] = v; }
+		}
+		for(size_t head = 0; head < tail; ++head){
+			const auto u = order[head];
+			for(const auto& e : m_graph[u]){
+				if(is_residual(e) && --degrees[e.to] == 0){ order[tail++] = e.to; }
+			}
+		}
+		return tail == n;
+	}
+
+	void initialize_potentials(){
+		const auto inf = positive_infinity<weight_type>();
+		const auto n = m_graph.size();
+		auto& h = m_potentials;
+		std::fill(h.begin(), h.end(), inf);
+		h[m_source] = weight_type();
+		if(compute_topological_order()){
+			for(const auto u : m_prev_vertex){
+				if(is_positive_infinity(h[u])){ continue; }
+				for(const auto& e : m_graph[u]){
+					if(!is_residual(e)){ continue; }
+					h[e.to] = std::min(h[e.to], h[u] + e.weight);
+				}
+			}
+			return;
+		}
+		auto& parents = m_prev_vertex;
+		std::fill(parents.begin(), parents.end(), n);
+		for(size_t iter = 0; iter < n; ++iter){
+			bool updated = false;
+			for(vertex_t u = 0; u < n; ++u){
+				if(is_positive_infinity(h[u])){ continue; }
+				for(const auto& e : m_graph[u]){
+					if(!is_residual(e) || !(h[u] + e.weight < h[e.to])){ continue; }
+					h[e.to] = h[u] + e.weight;
+					parents[e.to] = u;
+					updated = true;
+				}
+			}
+			if(!updated){ return; }
+		}
+		throw negative_cycle_error(
+			"graph has a negative cycle",
+			detail::find_parent_cycle(parents, m_work));
+	}
+
+	bool compute_distances(){
+		const auto inf = positive_infinity<weight_type>();
+		const auto& h = m_potentials;
+		auto& d = m_distances;
+		std::fill(d.begin(), d.end(), inf);
+		m_heap.clear();
+		d[m_source] = weight_type();
+		m_heap.push(weight_type(), m_source);
+		while(!m_heap.empty()){
+			const auto u = m_heap.top().second;
+			m_heap.pop();
+			const auto& edges = m_graph[u];
+			for(size_t i = 0; i < edges.size(); ++i){
+				const auto& e = edges[i];
+				if(!is_residual(e)){ continue; }
 				const auto v = e.to;
 				const auto t = d[u] + e.weight + h[u] - h[v];
 				if(d[v] <= t){ continue; }
 				d[v] = t;
-				prev_vertex[v] = u;
-				prev_edge[v] = i;
-				pq.emplace(t, v);
+				m_prev_vertex[v] = u;
+				m_prev_edge[v] = i;
+				m_heap.push(t, v);
+			}
+		}
+		return !is_positive_infinity(d[m_sink]);
+	}
+
+	void update_potentials(){
+		const auto n = m_graph.size();
+		const auto& d = m_distances;
+		weight_type max_distance = weight_type();
+		for(vertex_t v = 0; v < n; ++v){
+			if(!is_positive_infinity(d[v])){
+				max_distance = std::max(max_distance, d[v]);
 			}
 		}
-		if(is_positive_infinity(d[sink])){
-			throw no_solution_error("there are no enough capacities to flow");
+		for(vertex_t v = 0; v < n; ++v){
+			if(is_positive_infinity(m_potentials[v])){ continue; }
+			m_potentials[v] += is_positive_infinity(d[v]) ? max_distance : d[v];
 		}
-		for(size_t i = 0; i < n; ++i){ h[i] += d[i]; }
-		weight_type f = flow;
-		for(vertex_t v = sink; v != source; v = prev_vertex[v]){
-			const auto u = prev_vertex[v];
-			f = std::min(f, graph[u][prev_edge[v]].capacity);
+	}
+
+	// unit_cost is the length of the augmenting path, compared exactly without multiplication
+	void add_breakpoint(weight_type unit_cost){
+		const auto p = breakpoint_type(m_flow, m_cost);
+		if(m_breakpoints.size() >= 2 && unit_cost == m_last_unit_cost){
+			// drop the middle point when the slope does not change
+			m_breakpoints.back() = p;
+			return;
 		}
-		flow -= f;
-		result += f * h[sink];
-		for(vertex_t v = sink; v != source; v = prev_vertex[v]){
-			const auto u = prev_vertex[v];
-			auto& e = graph[u][prev_edge[v]];
-			e.capacity -= f;
-			graph[v][e.rev].capacity += f;
+		m_breakpoints.push_back(p);
+		m_last_unit_cost = unit_cost;
+	}
+
+
+public:
+	mincostflow_primal_dual_solver() = delete;
+	mincostflow_primal_dual_solver(const mincostflow_primal_dual_solver&) = delete;
+
+	/**
+	 * @param graph loquat::make_residual で生成した残余ネットワーク。
+	 *              容量が正の辺からなる部分グラフは source から到達可能な負閉路を持ってはいけません。
+	 */
+	mincostflow_primal_dual_solver(
+		vertex_t source,
+		vertex_t sink,
+		adjacency_list<edge_type>& graph)
+		: m_graph(graph)
+		, m_source(source)
+		, m_sink(sink)
+		, m_potentials(graph.size())
+		, m_distances(graph.size())
+		, m_prev_vertex(graph.size())
+		, m_prev_edge(graph.size())
+		, m_work(graph.size())
+		, m_heap(graph.size())
+		, m_flow(0)
+		, m_cost(0)
+		, m_breakpoints(1, breakpoint_type(0, 0))
+		, m_last_unit_cost()
+	{
+		initialize_potentials();
+	}
+
+
+	/**
+	 * @brief 最大で limit だけ流量を追加し、実際に追加した流量を返します。
+	 */
+	capacity_type augment(capacity_type limit){
+		capacity_type pushed = 0;
+		while(pushed < limit){
+			if(!compute_distances()){ break; }
+			update_potentials();
+			capacity_type f = limit - pushed;
+			for(vertex_t v = m_sink; v != m_source; v = m_prev_vertex[v]){
+				const auto u = m_prev_vertex[v];
+				f = std::min(f, m_graph[u][m_prev_edge[v]].capacity);
+			}
+			for(vertex_t v = m_sink; v != m_source; v = m_prev_vertex[v]){
+				const auto u = m_prev_vertex[v];
+				auto& e = m_graph[u][m_prev_edge[v]];
+				e.capacity -= f;
+				m_graph[v][e.rev].capacity += f;
+			}
+			pushed += f;
+			m_flow += f;
+			const auto unit_cost = m_potentials[m_sink] - m_potentials[m_source];
+			m_cost += f * unit_cost;
+			add_breakpoint(unit_cost);
 		}
+		return pushed;
+	}
+
+	/**
+	 * @brief これまでに流した流量の合計。
+	 */
+	capacity_type flow() const {
+		return m_flow;
 	}
-	return result;
-}
 
+	/**
+	 * @brief これまでに流した流れの費用の合計。
+	 */
+	weight_type cost() const {
+		return m_cost;
+	}
+
+	/**
+	 * @brief 流量と最小費用の関係を表す折れ線の頂点。
+	 *
+	 * (0, 0) から始まり、流量の昇順に並びます。
+	 * 隣接する頂点の間では最小費用は流量に対して線形で、傾きは単調非減少です。
+	 */
+	const std::vector<breakpoint_type>& breakpoints() const {
+		return m_breakpoints;
+	}
+
+};
+
+
+template <typename EdgeType>
+typename EdgeType::weight_type
+mincostflow_primal_dual(
+	typename EdgeType::capacity_type flow,
+	vertex_t source,
+	vertex_t sink,
+	adjacency_list<EdgeType>& graph)
+{
+	mincostflow_primal_dual_solver<EdgeType> solver(source, sink, graph);
+	if(solver.augment(flow) < flow){
+		throw no_solution_error("there are no enough capacities to flow");
+	}
+	return solver.cost();
 }
 
+}
@@ -0,0 +1,181 @@
+#pragma once
+#include <vector>
+#include <algorithm>
+#include "loquat/graph/adjacency_list.hpp"
+#include "loquat/misc/parallel.hpp"
+
+namespace loquat {
+
+namespace detail {
+
+// calls func(t, v) for the vertices levels[first, last), split over the pool
+template <typename Func>
+void for_each_in_level(
+	thread_pool& pool,
+	const std::vector<vertex_t>& levels,
+	size_t first,
+	size_t last,
+	size_t grain,
+	Func func)
+{
+	pool.for_blocks(last - first, grain, [&](size_t t, size_t lo, size_t hi){
+		for(size_t i = lo; i < hi; ++i){ func(t, levels[first + i]); }
+	});
+}
+
+template <typename EdgeType, typename Behavior, typename... Args>
+std::vector<typename Behavior::state_type>
+rerooting_dynamic_programming_impl(
+	const adjacency_list<EdgeType>& graph,
+	Behavior& behavior,
+	size_t num_threads,
+	Args&... args)
+{
+	using state_type = typename Behavior::state_type;
+	const size_t grain = 64;
+	const auto n = graph.size();
+
+	// BFS of all components, then vertices grouped by depth across components
+	std::vector<vertex_t> order, parents(n, n);
+	std::vector<size_t> depths(n, 0);
+	std::vector<bool> visited(n, false);
+	order.reserve(n);
+	size_t max_depth = 0;
+	for(vertex_t r = 0; r < n; ++r){
+		if(visited[r]){ continue; }
+		visited[r] = true;
+		const auto head_begin = order.size();
+		order.push_back(r);
+		for(size_t head = head_begin; head < order.size(); ++head){
+			const auto u = order[head];
+			for(const auto& e : graph[u]){
+				if(visited[e.to]){ continue; }
+				visited[e.to] = true;
+				parents[e.to] = u;
+				depths[e.to] = depths[u] + 1;
+				max_depth = std::max(max_depth, depths[e.to]);
+				order.push_back(e.to);
+			}
+		}
+	}
+	std::vector<size_t> level_offsets(max_depth + 2, 0);
+	for(vertex_t v = 0; v < n; ++v){ ++level_offsets[depths[v] + 1]; }
+	for(size_t d = 0; d <= max_depth; ++d){ level_offsets[d + 1] += level_offsets[d]; }
+	std::vector<vertex_t> levels(n);
+	{
+		std::vector<size_t> heads(level_offsets.begin(), level_offsets.end() - 1);
+		for(const auto v : order){ levels[heads[depths[v]]++] = v; }
+	}
+
+	// lifted contributions of each edge, laid out in the order of the adjacency lists
+	std::vector<size_t> offsets(n + 1, 0);
+	for(vertex_t u = 0; u < n; ++u){ offsets[u + 1] = offsets[u] + graph[u].size(); }
+	std::vector<state_type> lifted(offsets[n]);
+
+	thread_pool pool(num_threads);
+
+	// states of subtrees seen from their parents; a level only reads the level below
+	std::vector<state_type> down(n), up(n), result(n);
+	for(size_t d = max_depth + 1; n > 0 && d > 0; --d){
+		for_each_in_level(pool, levels, level_offsets[d - 1], level_offsets[d], grain,
+			[&](size_t, vertex_t u){
+			const auto& edges = graph[u];
+			state_type acc = behavior.identity();
+			for(size_t j = 0; j < edges.size(); ++j){
+				const auto& e = edges[j];
+				if(e.to == parents[u]){ continue; }
+				lifted[offsets[u] + j] = behavior.lift(down[e.to], u, e, args...);
+				acc = behavior.combine(acc, lifted[offsets[u] + j]);
+			}
+			down[u] = behavior.finalize(acc, u, args...);
+		});
+	}
+
+	// states of the remaining trees seen from children, using prefix and suffix sums;
+	// a level only reads the level above and writes up[] of its own children
+	std::vector<std::vector<state_type>> suffixes(pool.size());
+	for(size_t d = 0; n > 0 && d <= max_depth; ++d){
+		for_each_in_level(pool, levels, level_offsets[d], level_offsets[d + 1], grain,
+			[&](size_t t, vertex_t u){
+			auto& suffix = suffixes[t];
+			const auto& edges = graph[u];
+			const auto deg = edges.size();
+			const auto contributions = lifted.begin() + offsets[u];
+			for(size_t j = 0; j < deg; ++j){
+				const auto& e = edges[j];
+				if(e.to == parents[u]){
+					contributions[j] = behavior.lift(up[u], u, e, args...);
+				}
+			}
+			suffix.assign(deg + 1, behavior.identity());
+			for(size_t i = deg; i > 0; --i){
+				suffix[i - 1] = behavior.combine(contributions[i - 1], suffix[i]);
+			}
+			result[u] = behavior.finalize(suffix[0], u, args...);
+			state_type prefix = behavior.identity();
+			for(size_t i = 0; i < deg; ++i){
+				const auto v = edges[i].to;
+				if(v != parents[u]){
+					up[v] = behavior.finalize(
+						behavior.combine(prefix, suffix[i + 1]), u, args...);
+				}
+				prefix = behavior.combine(prefix, contributions[i]);
+			}
+		});
+	}
+	return result;
+}
+
+}
+
+
+/**
+ * @brief 全方位木 DP。各頂点を根としたときの根の状態を求めます。
+ *
+ * Behavior は次の操作を持つ必要があります。
+ * - state_type
+ * - state_type identity() : combine の単位元
+ * - state_type lift(const state_type& x, vertex_t u, const EdgeType& e, args...) :
+ *   e.to を根とする部分木の状態 x を、辺 e を通して u から見た寄与に変換します
+ * - state_type combine(const state_type& a, const state_type& b) : 寄与をまとめる結合的な演算
+ * - state_type finalize(const state_type& acc, vertex_t u, args...) :
+ *   寄与をまとめた acc から u を根とする部分木の状態を求めます
+ *
+ * 子の寄与を除く計算は累積和を左右から取って行うため、loquat::undirected_tree_dynamic_programming と
+ * 異なり purge (逆演算) を必要としません。graph は森であってもよく、各連結成分を独立に処理します。
+ * 頂点を深さごとにまとめ、葉から根への走査と根から葉への走査をそれぞれ 1 回ずつ行います。
+ * 葉から根への走査で lift した子の寄与は辺ごとに保持して再利用するため、lift は各有向辺について 1 回だけ呼ばれます。
+ */
+template <typename EdgeType, typename Behavior, typename... Args>
+std::vector<typename Behavior::state_type>
+rerooting_dynamic_programming(
+	const adjacency_list<EdgeType>& graph,
+	Behavior behavior,
+	Args&&... args)
+{
+	return detail::rerooting_dynamic_programming_impl(graph, behavior, 1, args...);
+}
+
+/**
+ * @brief 深さごとに並列に処理する全方位木 DP。
+ * @param num_threads 使用するスレッド数の上限。
+ *
+ * loquat::rerooting_dynamic_programming と同じ結果を求めます。
+ * 同じ深さの頂点は、異なる連結成分に属するものも含めて互いに独立なので、
+ * 各走査は深さごとに頂点を複数のスレッドで分担して処理します。
+ * 頂点が少ない深さは呼び出し元のスレッドのみで処理します。
+ * behavior の各操作と args は複数のスレッドから同時に呼び出されるため、スレッド安全である必要があります。
+ */
+template <typename EdgeType, typename Behavior, typename... Args>
+std::vector<typename Behavior::state_type>
+rerooting_dynamic_programming_parallel(
+	const adjacency_list<EdgeType>& graph,
+	size_t num_threads,
+	Behavior behavior,
+	Args&&... args)
+{
+	return detail::rerooting_dynamic_programming_impl(
+		graph, behavior, num_threads, args...);
+}
+
+}
@@ -0,0 +1,399 @@
+#pragma once
+#include <vector>
+#include <algorithm>
+#include <cassert>
+#include "loquat/graph/adjacency_list.hpp"
+#include "loquat/graph/algorithms.hpp"
+#include "loquat/graph/sssp_queue_policy.hpp"
+#include "loquat/graph/shortest_path_tree.hpp"
+#include "loquat/math/infinity.hpp"
+
+namespace loquat {
+
+namespace detail {
+
+template <typename WeightType>
+struct zero_heuristic {
+	WeightType operator()(vertex_t) const { return WeightType(); }
+};
+
+template <typename QueuePolicy, typename Queue, typename EdgeType, typename Heuristic>
+void prepare_astar_queue(
+	QueuePolicy, Queue& pq, const adjacency_list<EdgeType>&, Heuristic&)
+{
+	pq.clear();
+}
+
+// bucket widths must cover the keys shifted by the heuristic
+template <typename Queue, typename EdgeType, typename Heuristic>
+void prepare_astar_queue(
+	sssp_queue_policy::bucket,
+	Queue& pq,
+	const adjacency_list<EdgeType>& graph,
+	Heuristic& heuristic)
+{
+	using weight_type = typename Queue::key_type;
+	pq = sssp_queue_policy::bucket::make_queue<weight_type>(graph, heuristic);
+}
+
+template <typename Queue, typename EdgeType, typename WeightType>
+void prepare_astar_queue(
+	sssp_queue_policy::bucket,
+	Queue& pq,
+	const adjacency_list<EdgeType>&,
+	zero_heuristic<WeightType>&)
+{
+	pq.clear();
+}
+
+struct shortest_path_impl;
+
+}
+
+
+/**
+ * @brief 二頂点間の最短路クエリで再利用する作業領域。
+ * @tparam WeightType  辺の重みの型。
+ * @tparam QueuePolicy 使用する優先度付きキュー。
+ *
+ * 距離と親の配列、およびキューを構築時に一度だけ確保し、
+ * 各クエリの開始時には前回のクエリで値を書き換えた頂点のみを初期化します。
+ * そのため、クエリの計算量は探索した頂点と辺の数のみに依存します。
+ * 同じ作業領域を複数のスレッドから同時に使用することはできません。
+ */
+template <typename WeightType, typename QueuePolicy = sssp_queue_policy::automatic>
+class shortest_path_workspace {
+
+	friend struct detail::shortest_path_impl;
+
+public:
+	using weight_type = WeightType;
+	using queue_policy = QueuePolicy;
+	using queue_type = typename QueuePolicy::template queue_type<WeightType>;
+
+
+private:
+	std::vector<weight_type> m_dist[2];
+	std::vector<vertex_t> m_parents[2];
+	std::vector<vertex_t> m_touched;
+	queue_type m_queues[2];
+
+
+	void reset(){
+		const auto inf = positive_infinity<weight_type>();
+		const auto n = size();
+		for(const auto v : m_touched){
+			m_dist[0][v] = m_dist[1][v] = inf;
+			m_parents[0][v] = m_parents[1][v] = n;
+		}
+		m_touched.clear();
+		m_queues[0].clear();
+		m_queues[1].clear();
+	}
+
+	bool update(int side, vertex_t v, weight_type d, vertex_t parent){
+		auto& dist = m_dist[side];
+		if(!(d < dist[v])){ return false; }
+		if(is_positive_infinity(dist[v])){ m_touched.push_back(v); }
+		dist[v] = d;
+		m_parents[side][v] = parent;
+		return true;
+	}
+
+
+public:
+	template <typename EdgeType>
+	explicit shortest_path_workspace(const adjacency_list<EdgeType>& graph)
+		: m_dist()
+		, m_parents()
+		, m_touched()
+		, m_queues()
+	{
+		const auto n = graph.size();
+		for(int side = 0; side < 2; ++side){
+			m_dist[side].assign(n, positive_infinity<weight_type>());
+			m_parents[side].assign(n, n);
+		}
+		m_queues[0] = QueuePolicy::template make_queue<weight_type>(graph);
+		m_queues[1] = m_queues[0];
+	}
+
+
+	size_t size() const {
+		return m_dist[0].size();
+	}
+
+};
+
+
+namespace detail {
+
+struct shortest_path_impl {
+
+	template <typename Workspace>
+	static shortest_path_result<typename Workspace::weight_type>
+	make_result(const Workspace& ws, vertex_t meet, vertex_t target){
+		using weight_type = typename Workspace::weight_type;
+		const auto n = ws.size();
+		shortest_path_result<weight_type> result;
+		if(meet == n){
+			result.distance = positive_infinity<weight_type>();
+			return result;
+		}
+		result.distance = ws.m_dist[0][meet];
+		for(vertex_t v = meet; v != n; v = ws.m_parents[0][v]){
+			result.path.push_back(v);
+		}
+		std::reverse(result.path.begin(), result.path.end());
+		if(meet == target){ return result; }
+		result.distance += ws.m_dist[1][meet];
+		for(vertex_t v = ws.m_parents[1][meet]; v != n; v = ws.m_parents[1][v]){
+			result.path.push_back(v);
+		}
+		return result;
+	}
+
+	template <typename EdgeType, typename Heuristic, typename WeightType, typename QueuePolicy>
+	static shortest_path_result<WeightType> astar(
+		vertex_t source,
+		vertex_t target,
+		const adjacency_list<EdgeType>& graph,
+		Heuristic& heuristic,
+		shortest_path_workspace<WeightType, QueuePolicy>& ws)
+	{
+		using weight_type = WeightType;
+		assert(ws.size() == graph.size());
+		ws.reset();
+		auto& dist = ws.m_dist[0];
+		auto& pq = ws.m_queues[0];
+		prepare_astar_queue(QueuePolicy(), pq, graph, heuristic);
+		const weight_type offset = heuristic(source);
+		ws.update(0, source, weight_type(), graph.size());
+		pq.push(weight_type(), source);
+		while(!pq.empty()){
+			const auto top = pq.top();
+			const auto u = top.second;
+			pq.pop();
+			if(dist[u] + heuristic(u) - offset < top.first){ continue; }
+			if(u == target){ return make_result(ws, target, target); }
+			const auto x = dist[u];
+			for(const auto& e : graph[u]){
+				const auto v = e.to;
+				const auto y = x + e.weight;
+				if(ws.update(0, v, y, u)){
+					pq.push(y + heuristic(v) - offset, v);
+				}
+			}
+		}
+		return make_result(ws, is_positive_infinity(dist[target]) ? graph.size() : target, target);
+	}
+
+	template <typename EdgeType, typename WeightType, typename QueuePolicy>
+	static shortest_path_result<WeightType> bidirectional(
+		vertex_t source,
+		vertex_t target,
+		const adjacency_list<EdgeType>& graph,
+		const adjacency_list<EdgeType>& reversed_graph,
+		shortest_path_workspace<WeightType, QueuePolicy>& ws)
+	{
+		using weight_type = WeightType;
+		const auto inf = positive_infinity<weight_type>();
+		const auto n = graph.size();
+		assert(ws.size() == n);
+		ws.reset();
+		const adjacency_list<EdgeType> *graphs[2] = { &graph, &reversed_graph };
+		auto& forward_pq = ws.m_queues[0];
+		auto& backward_pq = ws.m_queues[1];
+		ws.update(0, source, weight_type(), n);
+		ws.update(1, target, weight_type(), n);
+		forward_pq.push(0, source);
+		backward_pq.push(0, target);
+		weight_type best = (source == target) ? weight_type() : inf;
+		vertex_t meet = (source == target) ? source : n;
+		while(!forward_pq.empty() && !backward_pq.empty()){
+			const auto forward_top = forward_pq.top();
+			const auto backward_top = backward_pq.top();
+			if(!is_positive_infinity(best) &&
+			   best <= forward_top.first + backward_top.first)
+			{
+				break;
+			}
+			const int side = (backward_top.first < forward_top.first) ? 1 : 0;
+			auto& pq = (side == 0 ? forward_pq : backward_pq);
+			const auto& top = (side == 0 ? forward_top : backward_top);
+			const auto x = top.first;
+			const auto u = top.second;
+			pq.pop();
+			const auto& d = ws.m_dist[side];
+			const auto& o = ws.m_dist[1 - side];
+			if(d[u] < x){ continue; }
+			for(const auto& e : (*graphs[side])[u]){
+				const auto v = e.to;
+				const auto y = x + e.weight;
+				if(!ws.update(side, v, y, u)){ continue; }
+				pq.push(y, v);
+				if(!is_positive_infinity(o[v]) && y + o[v] < best){
+					best = y + o[v];
+					meet = v;
+				}
+			}
+		}
+		return make_result(ws, meet, target);
+	}
+
+};
+
+}
+
+
+/**
+ * @brief A* 探索による二頂点間の最短路。
+ * @param heuristic 頂点から終点までの距離の下界を返す関数。
+ *                  辺 (u, v) について h(u) <= w(u, v) + h(v) を満たす必要があります。
+ * @param workspace graph から構築した作業領域。
+ *
+ * キューには始点からの距離と heuristic の和から heuristic(source) を引いた値をキーとして追加します。
+ * sssp_queue_policy::bucket を指定した場合は、各辺の w(u, v) + h(v) - h(u) の最大値を
+ * バケットの幅とするため、クエリごとにすべての頂点について heuristic を評価してキューを作り直します。
+ */
+template <typename EdgeType, typename Heuristic, typename QueuePolicy>
+shortest_path_result<typename EdgeType::weight_type>
+shortest_path_astar(
+	vertex_t source,
+	vertex_t target,
+	const adjacency_list<EdgeType>& graph,
+	Heuristic heuristic,
+	shortest_path_workspace<typename EdgeType::weight_type, QueuePolicy>& workspace)
+{
+	return detail::shortest_path_impl::astar(
+		source, target, graph, heuristic, workspace);
+}
+
+template <typename EdgeType, typename Heuristic, typename QueuePolicy>
+shortest_path_result<typename EdgeType::weight_type>
+shortest_path_astar(
+	vertex_t source,
+	vertex_t target,
+	const adjacency_list<EdgeType>& graph,
+	Heuristic heuristic,
+	QueuePolicy)
+{
+	using weight_type = typename EdgeType::weight_type;
+	shortest_path_workspace<weight_type, QueuePolicy> workspace(graph);
+	return shortest_path_astar(source, target, graph, heuristic, workspace);
+}
+
+template <typename EdgeType, typename Heuristic>
+shortest_path_result<typename EdgeType::weight_type>
+shortest_path_astar(
+	vertex_t source,
+	vertex_t target,
+	const adjacency_list<EdgeType>& graph,
+	Heuristic heuristic)
+{
+	return shortest_path_astar(
+		source, target, graph, heuristic, sssp_queue_policy::automatic());
+}
+
+
+/**
+ * @brief 終点が確定した時点で探索を打ち切る Dijkstra 法による二頂点間の最短路。
+ */
+template <typename EdgeType, typename QueuePolicy>
+shortest_path_result<typename EdgeType::weight_type>
+shortest_path(
+	vertex_t source,
+	vertex_t target,
+	const adjacency_list<EdgeType>& graph,
+	shortest_path_workspace<typename EdgeType::weight_type, QueuePolicy>& workspace)
+{
+	using weight_type = typename EdgeType::weight_type;
+	detail::zero_heuristic<weight_type> heuristic;
+	return detail::shortest_path_impl::astar(
+		source, target, graph, heuristic, workspace);
+}
+
+template <typename EdgeType, typename QueuePolicy>
+shortest_path_result<typename EdgeType::weight_type>
+shortest_path(
+	vertex_t source,
+	vertex_t target,
+	const adjacency_list<EdgeType>& graph,
+	QueuePolicy)
+{
+	using weight_type = typename EdgeType::weight_type;
+	shortest_path_workspace<weight_type, QueuePolicy> workspace(graph);
+	return shortest_path(source, target, graph, workspace);
+}
+
+template <typename EdgeType>
+shortest_path_result<typename EdgeType::weight_type>
+shortest_path(
+	vertex_t source,
+	vertex_t target,
+	const adjacency_list<EdgeType>& graph)
+{
+	return shortest_path(
+		source, target, graph, sssp_queue_policy::automatic());
+}
+
+
+/**
+ * @brief 双方向 Dijkstra 法による二頂点間の最短路。
+ * @param reversed_graph graph のすべての辺を反転したグラフ。
+ * @sa loquat::transpose
+ */
+template <typename EdgeType, typename QueuePolicy>
+shortest_path_result<typename EdgeType::weight_type>
+shortest_path_bidirectional(
+	vertex_t source,
+	vertex_t target,
+	const adjacency_list<EdgeType>& graph,
+	const adjacency_list<EdgeType>& reversed_graph,
+	shortest_path_workspace<typename EdgeType::weight_type, QueuePolicy>& workspace)
+{
+	return detail::shortest_path_impl::bidirectional(
+		source, target, graph, reversed_graph, workspace);
+}
+
+template <typename EdgeType, typename QueuePolicy>
+shortest_path_result<typename EdgeType::weight_type>
+shortest_path_bidirectional(
+	vertex_t source,
+	vertex_t target,
+	const adjacency_list<EdgeType>& graph,
+	const adjacency_list<EdgeType>& reversed_graph,
+	QueuePolicy)
+{
+	using weight_type = typename EdgeType::weight_type;
+	shortest_path_workspace<weight_type, QueuePolicy> workspace(graph);
+	return shortest_path_bidirectional(
+		source, target, graph, reversed_graph, workspace);
+}
+
+template <typename EdgeType>
+shortest_path_result<typename EdgeType::weight_type>
+shortest_path_bidirectional(
+	vertex_t source,
+	vertex_t target,
+	const adjacency_list<EdgeType>& graph,
+	const adjacency_list<EdgeType>& reversed_graph)
+{
+	return shortest_path_bidirectional(
+		source, target, graph, reversed_graph,
+		sssp_queue_policy::automatic());
+}
+
+template <typename EdgeType>
+shortest_path_result<typename EdgeType::weight_type>
+shortest_path_bidirectional(
+	vertex_t source,
+	vertex_t target,
+	const adjacency_list<EdgeType>& graph)
+{
+	return shortest_path_bidirectional(
+		source, target, graph, transpose(graph),
+		sssp_queue_policy::automatic());
+}
+
+}
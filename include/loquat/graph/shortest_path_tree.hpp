@@ -0,0 +1,53 @@
+#pragma once
+#include <vector>
+#include <algorithm>
+#include "loquat/graph/types.hpp"
+#include "loquat/math/infinity.hpp"
+
+namespace loquat {
+
+/**
+ * @brief 単一始点最短路の計算結果。
+ *
+ * parents[v] は最短路木における v の親頂点です。
+ * 始点および到達不可能な頂点については頂点数 n が格納されます。
+ */
+template <typename WeightType>
+struct shortest_path_tree {
+	using weight_type = WeightType;
+
+	std::vector<weight_type> distances;
+	std::vector<vertex_t> parents;
+};
+
+/**
+ * @brief 二頂点間の最短路の計算結果。
+ *
+ * path は始点から終点までの頂点列です。
+ * 到達不可能な場合 distance は正の無限大、path は空となります。
+ */
+template <typename WeightType>
+struct shortest_path_result {
+	using weight_type = WeightType;
+
+	weight_type distance;
+	std::vector<vertex_t> path;
+};
+
+
+template <typename WeightType>
+std::vector<vertex_t> restore_path(
+	const shortest_path_tree<WeightType>& tree,
+	vertex_t target)
+{
+	const auto n = tree.parents.size();
+	std::vector<vertex_t> path;
+	if(is_positive_infinity(tree.distances[target])){ return path; }
+	for(vertex_t v = target; v != n; v = tree.parents[v]){
+		path.push_back(v);
+	}
+	std::reverse(path.begin(), path.end());
+	return path;
+}
+
+}
@@ -1,6 +1,7 @@
 #pragma once
 #include <vector>
 #include <queue>
+#include <algorithm>
 #include "loquat/graph/adjacency_list.hpp"
 #include "loquat/math/infinity.hpp"
 #include "loquat/misc/exceptions.hpp"
@@ -14,8 +15,10 @@ sssp_bellman_ford(vertex_t source, const adjacency_list<EdgeType>& graph){
 	const auto inf = positive_infinity<weight_type>();
 	const auto n = graph.size();
 	std::vector<weight_type> result(n, inf);
+	std::vector<vertex_t> parents(n, n);
 	result[source] = weight_type();
 	bool finished = false;
+	vertex_t last_updated = n;
 	for(size_t iter = 0; !finished && iter < n; ++iter){
 		finished = true;
 		for(loquat::vertex_t u = 0; u < n; ++u){
@@ -24,16 +27,25 @@ sssp_bellman_ford(vertex_t source, const adjacency_list<EdgeType>& graph){
 				const auto v = e.to;
 				if((result[u] + e.weight) < result[v]){
 					result[v] = result[u] + e.weight;
+					parents[v] = u;
+					last_updated = v;
 					finished = false;
 				}
 			}
 		}
 	}
 	if(!finished){
-		throw no_solution_error("graph has a negative cycle");
+		vertex_t v = last_updated;
+		for(size_t i = 0; i < n; ++i){ v = parents[v]; }
+		std::vector<vertex_t> cycle;
+		for(vertex_t u = v; ; u = parents[u]){
+			cycle.push_back(u);
+			if(parents[u] == v){ break; }
+		}
+		std::reverse(cycle.begin(), cycle.end());
+		throw negative_cycle_error("graph has a negative cycle", cycle);
 	}
 	return result;
 }
 
 }
-
@@ -0,0 +1,158 @@
+#pragma once
+#include <vector>
+#include <limits>
+#include <utility>
+#include <algorithm>
+#include <stdexcept>
+#include "loquat/graph/adjacency_list.hpp"
+#include "loquat/math/infinity.hpp"
+#include "loquat/misc/parallel.hpp"
+
+namespace loquat {
+
+namespace detail {
+
+template <typename WeightType>
+WeightType default_delta(WeightType max_weight, size_t n, size_t m){
+	const size_t degree = (n == 0 || m <= n) ? 1 : (m + n - 1) / n;
+	const auto delta = max_weight / static_cast<WeightType>(degree);
+	return delta > 0 ? delta : WeightType(1);
+}
+
+}
+
+
+/**
+ * @brief Δ-stepping 法による単一始点最短路。
+ * @param delta       バケットの幅。重みが delta 以下の辺を軽い辺として扱います。
+ *                    正でない場合は std::invalid_argument を送出します。
+ * @param num_threads 緩和に使用するスレッド数の上限。
+ *
+ * 重みは非負でなければなりません。
+ * 各フェーズでは、同じバケットから取り出した頂点の辺を複数のスレッドで分担して走査し、
+ * 距離を更新しうる緩和の候補を集めます。候補の適用とバケットの更新は呼び出し元のスレッドで行います。
+ * スレッドは loquat::thread_pool として最初に一度だけ起動し、すべてのフェーズで使い回します。
+ * 取り出した頂点が少ないフェーズは呼び出し元のスレッドのみで処理します。
+ *
+ * バケットは最大の辺重みを delta で割った数だけ循環的に使用します。
+ * この数が頂点数を超える場合は、バケット数が頂点数程度に収まるよう delta を大きくして計算します。
+ */
+template <typename EdgeType>
+std::vector<typename EdgeType::weight_type>
+sssp_delta_stepping(
+	vertex_t source,
+	const adjacency_list<EdgeType>& graph,
+	typename EdgeType::weight_type delta,
+	size_t num_threads)
+{
+	using weight_type = typename EdgeType::weight_type;
+	using request_type = std::pair<vertex_t, weight_type>;
+	if(!(weight_type() < delta)){
+		throw std::invalid_argument("delta must be positive");
+	}
+	const size_t grain = 256;
+	const auto inf = positive_infinity<weight_type>();
+	const auto nil = std::numeric_limits<size_t>::max();
+	const auto n = graph.size();
+	weight_type max_weight = weight_type();
+	for(vertex_t u = 0; u < n; ++u){
+		for(const auto& e : graph[u]){
+			if(max_weight < e.weight){ max_weight = e.weight; }
+		}
+	}
+	const auto max_ratio = static_cast<weight_type>(std::max<size_t>(n, 1));
+	if(max_ratio < max_weight / delta){ delta = max_weight / max_ratio; }
+	const size_t num_slots = static_cast<size_t>(max_weight / delta) + 2;
+	std::vector<std::vector<vertex_t>> buckets(num_slots);
+	std::vector<size_t> positions(n, nil);
+	std::vector<weight_type> result(n, inf);
+	thread_pool pool(num_threads);
+	std::vector<std::vector<request_type>> requests(pool.size());
+	size_t num_queued = 0;
+
+	const auto relax = [&](vertex_t v, weight_type x){
+		if(!(x < result[v])){ return; }
+		result[v] = x;
+		const auto k = static_cast<size_t>(x / delta);
+		if(positions[v] == k){ return; }
+		if(positions[v] == nil){ ++num_queued; }
+		positions[v] = k;
+		buckets[k % num_slots].push_back(v);
+	};
+
+	// collects improving relaxations of light or heavy edges from vertices, reading result only
+	const auto relax_all = [&](const std::vector<vertex_t>& vertices, bool heavy){
+		const auto k = pool.for_blocks(
+			vertices.size(), grain,
+			[&](size_t t, size_t first, size_t last){
+				auto& out = requests[t];
+				out.clear();
+				for(size_t i = first; i < last; ++i){
+					const auto u = vertices[i];
+					const auto x = result[u];
+					for(const auto& e : graph[u]){
+						if((delta < e.weight) != heavy){ continue; }
+						const auto y = x + e.weight;
+						if(y < result[e.to]){ out.emplace_back(e.to, y); }
+					}
+				}
+			});
+		for(size_t t = 0; t < k; ++t){
+			for(const auto& r : requests[t]){ relax(r.first, r.second); }
+		}
+	};
+
+	std::vector<vertex_t> current, frontier, settled;
+	relax(source, weight_type());
+	for(size_t k = 0; num_queued > 0; ++k){
+		auto& bucket = buckets[k % num_slots];
+		settled.clear();
+		while(!bucket.empty()){
+			current.clear();
+			current.swap(bucket);
+			frontier.clear();
+			for(const auto u : current){
+				if(positions[u] != k){ continue; }
+				positions[u] = nil;
+				--num_queued;
+				frontier.push_back(u);
+			}
+			settled.insert(settled.end(), frontier.begin(), frontier.end());
+			relax_all(frontier, false);
+		}
+		relax_all(settled, true);
+	}
+	return result;
+}
+
+template <typename EdgeType>
+std::vector<typename EdgeType::weight_type>
+sssp_delta_stepping(
+	vertex_t source,
+	const adjacency_list<EdgeType>& graph,
+	typename EdgeType::weight_type delta)
+{
+	return sssp_delta_stepping(source, graph, delta, hardware_concurrency());
+}
+
+template <typename EdgeType>
+std::vector<typename EdgeType::weight_type>
+sssp_delta_stepping(
+	vertex_t source,
+	const adjacency_list<EdgeType>& graph)
+{
+	using weight_type = typename EdgeType::weight_type;
+	const auto n = graph.size();
+	size_t m = 0;
+	weight_type max_weight = weight_type();
+	for(vertex_t u = 0; u < n; ++u){
+		m += graph[u].size();
+		for(const auto& e : graph[u]){
+			if(max_weight < e.weight){ max_weight = e.weight; }
+		}
+	}
+	return sssp_delta_stepping(
+		source, graph, detail::default_delta(max_weight, n, m));
+}
+
+}
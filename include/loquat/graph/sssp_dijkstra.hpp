@@ -1,27 +1,30 @@
 #pragma once
 #include <vector>
-#include <queue>
 #include "loquat/graph/adjacency_list.hpp"
+#include "loquat/graph/sssp_queue_policy.hpp"
+#include "loquat/graph/shortest_path_tree.hpp"
 #include "loquat/math/infinity.hpp"
 
 namespace loquat {
 
-template <typename EdgeType>
+template <typename EdgeType, typename QueuePolicy>
 std::vector<typename EdgeType::weight_type>
-sssp_dijkstra(vertex_t source, const adjacency_list<EdgeType>& graph){
+sssp_dijkstra(
+	vertex_t source,
+	const adjacency_list<EdgeType>& graph,
+	QueuePolicy)
+{
 	using weight_type = typename EdgeType::weight_type;
-	using pair_type = std::pair<weight_type, vertex_t>;
-	using queue_type = std::priority_queue<
-		pair_type, std::vector<pair_type>, std::greater<pair_type>>;
 	const auto inf = positive_infinity<weight_type>();
 	const auto n = graph.size();
 	std::vector<weight_type> result(n, inf);
-	queue_type pq;
+	auto pq = QueuePolicy::template make_queue<weight_type>(graph);
 	result[source] = 0;
-	pq.emplace(0, source);
+	pq.push(0, source);
 	while(!pq.empty()){
-		const auto x = pq.top().first;
-		const auto u = pq.top().second;
+		const auto top = pq.top();
+		const auto x = top.first;
+		const auto u = top.second;
 		pq.pop();
 		if(result[u] < x){ continue; }
 		for(const auto& e : graph[u]){
@@ -29,12 +32,61 @@ sssp_dijkstra(vertex_t source, const adjacency_list<EdgeType>& graph){
 			const auto y = x + e.weight;
 			if(y < result[v]){
 				result[v] = y;
-				pq.emplace(y, v);
+				pq.push(y, v);
+			}
+		}
+	}
+	return result;
+}
+
+template <typename EdgeType>
+std::vector<typename EdgeType::weight_type>
+sssp_dijkstra(vertex_t source, const adjacency_list<EdgeType>& graph){
+	return sssp_dijkstra(source, graph, sssp_queue_policy::automatic());
+}
+
+
+template <typename EdgeType, typename QueuePolicy>
+shortest_path_tree<typename EdgeType::weight_type>
+sssp_dijkstra_tree(
+	vertex_t source,
+	const adjacency_list<EdgeType>& graph,
+	QueuePolicy)
+{
+	using weight_type = typename EdgeType::weight_type;
+	const auto inf = positive_infinity<weight_type>();
+	const auto n = graph.size();
+	shortest_path_tree<weight_type> result;
+	auto& dist = result.distances;
+	auto& parents = result.parents;
+	dist.assign(n, inf);
+	parents.assign(n, n);
+	auto pq = QueuePolicy::template make_queue<weight_type>(graph);
+	dist[source] = 0;
+	pq.push(0, source);
+	while(!pq.empty()){
+		const auto top = pq.top();
+		const auto x = top.first;
+		const auto u = top.second;
+		pq.pop();
+		if(dist[u] < x){ continue; }
+		for(const auto& e : graph[u]){
+			const auto v = e.to;
+			const auto y = x + e.weight;
+			if(y < dist[v]){
+				dist[v] = y;
+				parents[v] = u;
+				pq.push(y, v);
 			}
 		}
 	}
 	return result;
 }
 
+template <typename EdgeType>
+shortest_path_tree<typename EdgeType::weight_type>
+sssp_dijkstra_tree(vertex_t source, const adjacency_list<EdgeType>& graph){
+	return sssp_dijkstra_tree(source, graph, sssp_queue_policy::automatic());
 }
 
+}
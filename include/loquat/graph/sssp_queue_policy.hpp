@@ -0,0 +1,190 @@
+#pragma once
+#include <vector>
+#include <algorithm>
+#include <functional>
+#include <type_traits>
+#include <utility>
+#include "loquat/graph/adjacency_list.hpp"
+#include "loquat/container/radix_heap.hpp"
+#include "loquat/container/bucket_queue.hpp"
+#include "loquat/container/indexed_d_ary_heap.hpp"
+
+namespace loquat {
+
+namespace detail {
+
+template <typename Key, typename Value>
+class binary_heap_queue {
+
+public:
+	using key_type = Key;
+	using mapped_type = Value;
+	using value_type = std::pair<key_type, mapped_type>;
+
+private:
+	std::vector<value_type> m_queue;
+
+public:
+	binary_heap_queue()
+		: m_queue()
+	{ }
+
+	bool empty() const {
+		return m_queue.empty();
+	}
+
+	size_t size() const {
+		return m_queue.size();
+	}
+
+	const value_type& top() const {
+		return m_queue.front();
+	}
+
+	void push(const key_type& key, const mapped_type& value){
+		m_queue.emplace_back(key, value);
+		std::push_heap(m_queue.begin(), m_queue.end(), std::greater<value_type>());
+	}
+
+	void pop(){
+		std::pop_heap(m_queue.begin(), m_queue.end(), std::greater<value_type>());
+		m_queue.pop_back();
+	}
+
+	void clear(){
+		m_queue.clear();
+	}
+
+};
+
+}
+
+
+/**
+ * @brief 最短路探索で使用する優先度付きキューの選択肢。
+ *
+ * 各ポリシーは重みの型から決まるキューの型 queue_type と、
+ * グラフからキューを生成する make_queue を提供します。
+ * キューは <tt>push(key, vertex)</tt>, <tt>top()</tt>, <tt>pop()</tt>, <tt>empty()</tt>, <tt>clear()</tt> を持ちます。
+ */
+namespace sssp_queue_policy {
+
+/**
+ * @brief 遅延削除を伴う二分ヒープ。任意の重み型で使用できます。
+ */
+struct binary_heap {
+
+	template <typename WeightType>
+	using queue_type = detail::binary_heap_queue<WeightType, vertex_t>;
+
+	template <typename WeightType, typename EdgeType>
+	static queue_type<WeightType> make_queue(const adjacency_list<EdgeType>&){
+		return queue_type<WeightType>();
+	}
+
+};
+
+/**
+ * @brief 添字付き4分ヒープ。キーの減少を直接行うため重複した要素を持ちません。
+ */
+struct d_ary_heap {
+
+	template <typename WeightType>
+	using queue_type = indexed_d_ary_heap<WeightType, 4>;
+
+	template <typename WeightType, typename EdgeType>
+	static queue_type<WeightType> make_queue(const adjacency_list<EdgeType>& graph){
+		return queue_type<WeightType>(graph.size());
+	}
+
+};
+
+/**
+ * @brief 基数ヒープ。非負の整数重みでのみ使用できます。
+ */
+struct radix_heap {
+
+	template <typename WeightType>
+	using queue_type = loquat::radix_heap<WeightType, vertex_t>;
+
+	template <typename WeightType, typename EdgeType>
+	static queue_type<WeightType> make_queue(const adjacency_list<EdgeType>&){
+		return queue_type<WeightType>();
+	}
+
+};
+
+/**
+ * @brief Dial のバケットキュー。最大の辺重みが小さい非負の整数重みで使用できます。
+ *
+ * 最大の辺重みに比例するメモリを使用します。
+ */
+struct bucket {
+
+	template <typename WeightType>
+	using queue_type = bucket_queue<WeightType, vertex_t>;
+
+	template <typename WeightType, typename EdgeType>
+	static queue_type<WeightType> make_queue(const adjacency_list<EdgeType>& graph){
+		const auto n = graph.size();
+		WeightType max_weight = WeightType();
+		for(vertex_t u = 0; u < n; ++u){
+			for(const auto& e : graph[u]){
+				if(max_weight < e.weight){ max_weight = e.weight; }
+			}
+		}
+		return queue_type<WeightType>(static_cast<size_t>(max_weight));
+	}
+
+	/**
+	 * @brief ポテンシャル potential で変換した辺重み w(u, v) + p(v) - p(u) に合わせたキューを生成します。
+	 *
+	 * A* 探索のようにキーが距離とポテンシャルの和となる場合に使用します。
+	 * 変換後の辺重みはすべて非負である必要があります。
+	 */
+	template <typename WeightType, typename EdgeType, typename Potential>
+	static queue_type<WeightType> make_queue(
+		const adjacency_list<EdgeType>& graph,
+		Potential& potential)
+	{
+		const auto n = graph.size();
+		WeightType max_weight = WeightType();
+		for(vertex_t u = 0; u < n; ++u){
+			const WeightType pu = potential(u);
+			for(const auto& e : graph[u]){
+				const WeightType w = e.weight + potential(e.to) - pu;
+				if(max_weight < w){ max_weight = w; }
+			}
+		}
+		return queue_type<WeightType>(static_cast<size_t>(max_weight));
+	}
+
+};
+
+/**
+ * @brief 重みの型に応じて自動的に選択されるキュー。
+ *
+ * 符号なし整数の重みでは基数ヒープ、それ以外では添字付き4分ヒープを使用します。
+ * 符号付き整数の重みに基数ヒープを使用しないのは、負の重みを持つ辺が含まれていた場合にも
+ * 基数ヒープの単調性の仮定を破らないようにするためです。
+ */
+struct automatic {
+
+	template <typename WeightType>
+	using policy_type = typename std::conditional<
+		std::is_unsigned<WeightType>::value, radix_heap, d_ary_heap>::type;
+
+	template <typename WeightType>
+	using queue_type =
+		typename policy_type<WeightType>::template queue_type<WeightType>;
+
+	template <typename WeightType, typename EdgeType>
+	static queue_type<WeightType> make_queue(const adjacency_list<EdgeType>& graph){
+		return policy_type<WeightType>::template make_queue<WeightType>(graph);
+	}
+
+};
+
+}
+
+}
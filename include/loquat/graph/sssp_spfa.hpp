@@ -0,0 +1,227 @@
+#pragma once
+#include <vector>
+#include <deque>
+#include <tuple>
+#include <algorithm>
+#include "loquat/graph/adjacency_list.hpp"
+#include "loquat/math/infinity.hpp"
+#include "loquat/misc/exceptions.hpp"
+#include "loquat/misc/parallel.hpp"
+
+namespace loquat {
+
+namespace detail {
+
+inline std::vector<vertex_t> find_parent_cycle(
+	const std::vector<vertex_t>& parents,
+	std::vector<size_t>& stamps)
+{
+	const auto n = parents.size();
+	std::fill(stamps.begin(), stamps.end(), 0);
+	for(vertex_t r = 0; r < n; ++r){
+		if(stamps[r] != 0){ continue; }
+		vertex_t u = r;
+		while(u != n && stamps[u] == 0){
+			stamps[u] = r + 1;
+			u = parents[u];
+		}
+		if(u == n || stamps[u] != r + 1){ continue; }
+		std::vector<vertex_t> cycle;
+		vertex_t v = u;
+		do {
+			cycle.push_back(v);
+			v = parents[v];
+		} while(v != u);
+		std::reverse(cycle.begin(), cycle.end());
+		return cycle;
+	}
+	return std::vector<vertex_t>();
+}
+
+template <typename EdgeType>
+std::vector<vertex_t> spfa_impl(
+	const adjacency_list<EdgeType>& graph,
+	std::vector<typename EdgeType::weight_type>& dist,
+	std::vector<vertex_t>& parents,
+	std::deque<vertex_t>& q)
+{
+	const auto n = graph.size();
+	std::vector<bool> in_queue(n);
+	std::vector<size_t> stamps(n);
+	long double sum = 0;
+	for(const auto v : q){
+		in_queue[v] = true;
+		sum += dist[v];
+	}
+	size_t relaxations = 0;
+	while(!q.empty()){
+		for(size_t k = q.size(); k > 1; --k){
+			const auto f = q.front();
+			if(static_cast<long double>(dist[f]) * q.size() <= sum){ break; }
+			q.pop_front();
+			q.push_back(f);
+		}
+		const auto u = q.front();
+		q.pop_front();
+		in_queue[u] = false;
+		sum -= dist[u];
+		const auto x = dist[u];
+		for(const auto& e : graph[u]){
+			const auto v = e.to;
+			const auto y = x + e.weight;
+			if(!(y < dist[v])){ continue; }
+			if(in_queue[v]){ sum -= dist[v]; }
+			dist[v] = y;
+			parents[v] = u;
+			if(++relaxations >= n){
+				relaxations = 0;
+				auto cycle = find_parent_cycle(parents, stamps);
+				if(!cycle.empty()){ return cycle; }
+			}
+			sum += y;
+			if(in_queue[v]){ continue; }
+			in_queue[v] = true;
+			if(!q.empty() && y < dist[q.front()]){
+				q.push_front(v);
+			}else{
+				q.push_back(v);
+			}
+		}
+	}
+	return std::vector<vertex_t>();
+}
+
+// relaxes the edges of all vertices updated in the previous round at once
+template <typename EdgeType>
+std::vector<vertex_t> spfa_rounds_impl(
+	const adjacency_list<EdgeType>& graph,
+	std::vector<typename EdgeType::weight_type>& dist,
+	std::vector<vertex_t>& parents,
+	std::vector<vertex_t> frontier,
+	size_t num_threads)
+{
+	using weight_type = typename EdgeType::weight_type;
+	using request_type = std::tuple<vertex_t, weight_type, vertex_t>;
+	const size_t grain = 256;
+	const auto n = graph.size();
+	std::vector<unsigned char> in_next(n, 0);
+	std::vector<size_t> stamps(n);
+	std::vector<vertex_t> next;
+	thread_pool pool(num_threads);
+	std::vector<std::vector<request_type>> requests(pool.size());
+	size_t relaxations = 0;
+	while(!frontier.empty()){
+		// dist is only read while the edges are scanned
+		const auto k = pool.for_blocks(frontier.size(), grain,
+			[&](size_t t, size_t first, size_t last){
+				auto& out = requests[t];
+				out.clear();
+				for(size_t i = first; i < last; ++i){
+					const auto u = frontier[i];
+					const auto x = dist[u];
+					for(const auto& e : graph[u]){
+						const auto y = x + e.weight;
+						if(y < dist[e.to]){ out.emplace_back(e.to, y, u); }
+					}
+				}
+			});
+		next.clear();
+		for(size_t t = 0; t < k; ++t){
+			for(const auto& r : requests[t]){
+				const auto v = std::get<0>(r);
+				const auto y = std::get<1>(r);
+				if(!(y < dist[v])){ continue; }
+				dist[v] = y;
+				parents[v] = std::get<2>(r);
+				++relaxations;
+				if(in_next[v]){ continue; }
+				in_next[v] = 1;
+				next.push_back(v);
+			}
+		}
+		for(const auto v : next){ in_next[v] = 0; }
+		if(relaxations >= n){
+			relaxations = 0;
+			auto cycle = find_parent_cycle(parents, stamps);
+			if(!cycle.empty()){ return cycle; }
+		}
+		frontier.swap(next);
+	}
+	return std::vector<vertex_t>();
+}
+
+}
+
+
+/**
+ * @brief キューを用いた Bellman-Ford 法 (SPFA) による単一始点最短路。
+ *
+ * 距離が更新された頂点のみを走査します。
+ * キューの操作には SLF (Small Label First) と LLL (Large Label Last) の両方の規則を用います。
+ * 始点から到達可能な負閉路が存在する場合、その閉路を持つ loquat::negative_cycle_error を送出します。
+ */
+template <typename EdgeType>
+std::vector<typename EdgeType::weight_type>
+sssp_spfa(vertex_t source, const adjacency_list<EdgeType>& graph){
+	using weight_type = typename EdgeType::weight_type;
+	const auto inf = positive_infinity<weight_type>();
+	const auto n = graph.size();
+	std::vector<weight_type> result(n, inf);
+	std::vector<vertex_t> parents(n, n);
+	std::deque<vertex_t> q;
+	result[source] = weight_type();
+	q.push_back(source);
+	auto cycle = detail::spfa_impl(graph, result, parents, q);
+	if(!cycle.empty()){
+		throw negative_cycle_error("graph has a negative cycle", std::move(cycle));
+	}
+	return result;
+}
+
+/**
+ * @brief 距離が更新された頂点をラウンドごとにまとめて緩和する並列な Bellman-Ford 法。
+ * @param num_threads 緩和に使用するスレッド数の上限。
+ *
+ * 各ラウンドでは、前のラウンドで距離が更新された頂点の辺を複数のスレッドで分担して走査し、
+ * 距離を更新しうる緩和の候補を集めます。候補の適用は呼び出し元のスレッドで行います。
+ * SLF と LLL の規則は用いないため、走査する辺の数は逐次版より多くなることがあります。
+ * 始点から到達可能な負閉路が存在する場合、その閉路を持つ loquat::negative_cycle_error を送出します。
+ */
+template <typename EdgeType>
+std::vector<typename EdgeType::weight_type>
+sssp_spfa(
+	vertex_t source,
+	const adjacency_list<EdgeType>& graph,
+	size_t num_threads)
+{
+	using weight_type = typename EdgeType::weight_type;
+	const auto inf = positive_infinity<weight_type>();
+	const auto n = graph.size();
+	std::vector<weight_type> result(n, inf);
+	std::vector<vertex_t> parents(n, n);
+	result[source] = weight_type();
+	auto cycle = detail::spfa_rounds_impl(
+		graph, result, parents, std::vector<vertex_t>(1, source), num_threads);
+	if(!cycle.empty()){
+		throw negative_cycle_error("graph has a negative cycle", std::move(cycle));
+	}
+	return result;
+}
+
+/**
+ * @brief グラフ全体から負閉路を1つ探す。
+ *
+ * 負閉路が存在しない場合は空の列を返します。
+ */
+template <typename EdgeType>
+std::vector<vertex_t> find_negative_cycle(const adjacency_list<EdgeType>& graph){
+	using weight_type = typename EdgeType::weight_type;
+	const auto n = graph.size();
+	std::vector<weight_type> dist(n, weight_type());
+	std::vector<vertex_t> parents(n, n);
+	std::deque<vertex_t> q;
+	for(vertex_t v = 0; v < n; ++v){ q.push_back(v); }
+	return detail::spfa_impl(graph, dist, parents, q);
+}
+
+}
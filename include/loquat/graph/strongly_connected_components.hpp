@@ -55,5 +55,79 @@ belonging_components_t strongly_connected_components(
 	return std::move(scc);
 }
 
+
+/**
+ * @brief Pearce の方法による強連結成分分解。
+ * @return 各頂点が属する強連結成分の番号。
+ *
+ * 深さ優先探索を 1 回だけ行い、補助領域は頂点数に比例する配列のみを使用します。
+ * 強連結成分には 0 から成分数 - 1 までの番号が逆トポロジカル順に振られます。
+ * つまり、辺 (u, v) について result[u] >= result[v] が成り立ちます。
+ */
+template <typename EdgeType>
+belonging_components_t strongly_connected_components_pearce(
+	const adjacency_list<EdgeType>& graph)
+{
+	const auto n = graph.size();
+	// rindex holds the DFS index while a vertex is on the stack,
+	// and n - 1 - (component id) after its component is completed
+	std::vector<size_t> rindex(n, 0);
+	std::vector<size_t> iterators(n, 0);
+	std::vector<bool> is_root(n, false);
+	std::vector<vertex_t> call_stack, vertex_stack;
+	size_t index = 1, component = n - 1;
+
+	const auto begin_visit = [&](vertex_t v){
+		is_root[v] = true;
+		rindex[v] = index++;
+		iterators[v] = 0;
+		call_stack.push_back(v);
+	};
+	const auto finish_edge = [&](vertex_t v, vertex_t w){
+		if(rindex[w] < rindex[v]){
+			rindex[v] = rindex[w];
+			is_root[v] = false;
+		}
+	};
+
+	for(vertex_t r = 0; r < n; ++r){
+		if(rindex[r] != 0){ continue; }
+		begin_visit(r);
+		while(!call_stack.empty()){
+			const auto v = call_stack.back();
+			if(iterators[v] < graph[v].size()){
+				const auto w = graph[v][iterators[v]].to;
+				if(rindex[w] == 0){
+					begin_visit(w);
+				}else{
+					finish_edge(v, w);
+					++iterators[v];
+				}
+				continue;
+			}
+			call_stack.pop_back();
+			if(is_root[v]){
+				--index;
+				while(!vertex_stack.empty() &&
+				      rindex[v] <= rindex[vertex_stack.back()])
+				{
+					rindex[vertex_stack.back()] = component;
+					vertex_stack.pop_back();
+					--index;
+				}
+				rindex[v] = component--;
+			}else{
+				vertex_stack.push_back(v);
+			}
+			if(!call_stack.empty()){
+				const auto u = call_stack.back();
+				finish_edge(u, v);
+				++iterators[u];
+			}
+		}
+	}
+	for(vertex_t v = 0; v < n; ++v){ rindex[v] = n - 1 - rindex[v]; }
+	return rindex;
 }
 
+}
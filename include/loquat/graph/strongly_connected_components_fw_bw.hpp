@@ -0,0 +1,361 @@
+#pragma once
+#include <vector>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <limits>
+#include <utility>
+#include <condition_variable>
+#include "loquat/graph/adjacency_list.hpp"
+#include "loquat/graph/component_graph.hpp"
+#include "loquat/misc/parallel.hpp"
+
+namespace loquat {
+
+namespace detail {
+
+class scc_fw_bw_impl {
+
+private:
+	struct task {
+		std::vector<vertex_t> vertices;
+		size_t color;
+	};
+
+	// per-thread work areas
+	struct scratch {
+		std::vector<vertex_t> queue;
+		std::vector<vertex_t> call_stack;
+		std::vector<vertex_t> vertex_stack;
+	};
+
+	// forward and backward adjacency in CSR form
+	std::vector<size_t> m_out_offsets;
+	std::vector<vertex_t> m_out_targets;
+	std::vector<size_t> m_in_offsets;
+	std::vector<vertex_t> m_in_targets;
+
+	// a vertex belongs to the subproblem with the same color,
+	// and is colored with dead_color() once its component is determined
+	std::vector<std::atomic<size_t>> m_colors;
+	std::atomic<size_t> m_num_colors;
+	size_t m_sequential_threshold;
+
+	// the following are only accessed by the thread owning the vertex
+	std::vector<unsigned char> m_marks;
+	std::vector<size_t> m_in_degrees;
+	std::vector<size_t> m_out_degrees;
+	belonging_components_t m_result;
+
+	std::mutex m_mutex;
+	std::condition_variable m_condition;
+	std::vector<task> m_tasks;
+	size_t m_num_active;
+
+	enum : unsigned char {
+		forward_mark  = 1,
+		backward_mark = 2,
+		root_mark     = 4
+	};
+
+	static size_t dead_color(){
+		return std::numeric_limits<size_t>::max();
+	}
+
+	template <typename EdgeType>
+	scc_fw_bw_impl(
+		const adjacency_list<EdgeType>& graph,
+		size_t sequential_threshold)
+		: m_out_offsets(graph.size() + 1, 0)
+		, m_out_targets()
+		, m_in_offsets(graph.size() + 1, 0)
+		, m_in_targets()
+		, m_colors(graph.size())
+		, m_num_colors(1)
+		, m_sequential_threshold(sequential_threshold)
+		, m_marks(graph.size(), 0)
+		, m_in_degrees(graph.size(), 0)
+		, m_out_degrees(graph.size(), 0)
+		, m_result(graph.size(), graph.size())
+		, m_mutex()
+		, m_condition()
+		, m_tasks()
+		, m_num_active(0)
+	{
+		const auto n = graph.size();
+		for(vertex_t u = 0; u < n; ++u){
+			m_out_offsets[u + 1] = m_out_offsets[u] + graph[u].size();
+			for(const auto& e : graph[u]){ ++m_in_offsets[e.to + 1]; }
+			m_colors[u].store(0, std::memory_order_relaxed);
+		}
+		for(vertex_t v = 0; v < n; ++v){ m_in_offsets[v + 1] += m_in_offsets[v]; }
+		m_out_targets.resize(m_out_offsets[n]);
+		m_in_targets.resize(m_in_offsets[n]);
+		std::vector<size_t> heads(m_in_offsets.begin(), m_in_offsets.end() - 1);
+		for(vertex_t u = 0; u < n; ++u){
+			size_t k = m_out_offsets[u];
+			for(const auto& e : graph[u]){
+				m_out_targets[k++] = e.to;
+				m_in_targets[heads[e.to]++] = u;
+			}
+		}
+	}
+
+	bool is_alive(vertex_t v, size_t color) const {
+		return m_colors[v].load(std::memory_order_relaxed) == color;
+	}
+
+	void assign(vertex_t v, vertex_t representative){
+		m_result[v] = representative;
+		m_colors[v].store(dead_color(), std::memory_order_relaxed);
+	}
+
+	// removes vertices without incoming or outgoing edges in the subproblem
+	void trim(std::vector<vertex_t>& vertices, size_t color, scratch& s){
+		auto& queue = s.queue;
+		queue.clear();
+		for(const auto v : vertices){
+			size_t in_degree = 0, out_degree = 0;
+			for(size_t k = m_in_offsets[v]; k < m_in_offsets[v + 1]; ++k){
+				if(is_alive(m_in_targets[k], color)){ ++in_degree; }
+			}
+			for(size_t k = m_out_offsets[v]; k < m_out_offsets[v + 1]; ++k){
+				if(is_alive(m_out_targets[k], color)){ ++out_degree; }
+			}
+			m_in_degrees[v] = in_degree;
+			m_out_degrees[v] = out_degree;
+		}
+		for(const auto v : vertices){
+			if(m_in_degrees[v] == 0 || m_out_degrees[v] == 0){
+				assign(v, v);
+				queue.push_back(v);
+			}
+		}
+		for(size_t head = 0; head < queue.size(); ++head){
+			const auto v = queue[head];
+			for(size_t k = m_out_offsets[v]; k < m_out_offsets[v + 1]; ++k){
+				const auto w = m_out_targets[k];
+				if(!is_alive(w, color)){ continue; }
+				if(--m_in_degrees[w] == 0){
+					assign(w, w);
+					queue.push_back(w);
+				}
+			}
+			for(size_t k = m_in_offsets[v]; k < m_in_offsets[v + 1]; ++k){
+				const auto w = m_in_targets[k];
+				if(!is_alive(w, color)){ continue; }
+				if(--m_out_degrees[w] == 0){
+					assign(w, w);
+					queue.push_back(w);
+				}
+			}
+		}
+		size_t tail = 0;
+		for(const auto v : vertices){
+			if(is_alive(v, color)){ vertices[tail++] = v; }
+		}
+		vertices.resize(tail);
+	}
+
+	void reach(
+		vertex_t pivot, size_t color, unsigned char mark,
+		const std::vector<size_t>& offsets,
+		const std::vector<vertex_t>& targets,
+		scratch& s)
+	{
+		auto& queue = s.queue;
+		queue.clear();
+		m_marks[pivot] |= mark;
+		queue.push_back(pivot);
+		for(size_t head = 0; head < queue.size(); ++head){
+			const auto v = queue[head];
+			for(size_t k = offsets[v]; k < offsets[v + 1]; ++k){
+				const auto w = targets[k];
+				if(!is_alive(w, color) || (m_marks[w] & mark)){ continue; }
+				m_marks[w] |= mark;
+				queue.push_back(w);
+			}
+		}
+	}
+
+	// Pearce's algorithm restricted to the subproblem,
+	// using m_in_degrees as DFS indices and m_out_degrees as edge cursors
+	void solve_sequential(const std::vector<vertex_t>& vertices, size_t color, scratch& s){
+		auto& rindex = m_in_degrees;
+		auto& cursors = m_out_degrees;
+		auto& call_stack = s.call_stack;
+		auto& vertex_stack = s.vertex_stack;
+		for(const auto v : vertices){ rindex[v] = 0; }
+		size_t index = 1;
+		const auto begin_visit = [&](vertex_t v){
+			m_marks[v] |= root_mark;
+			rindex[v] = index++;
+			cursors[v] = m_out_offsets[v];
+			call_stack.push_back(v);
+		};
+		const auto finish_edge = [&](vertex_t v, vertex_t w){
+			if(rindex[w] < rindex[v]){
+				rindex[v] = rindex[w];
+				m_marks[v] &= ~root_mark;
+			}
+		};
+		for(const auto r : vertices){
+			if(!is_alive(r, color) || rindex[r] != 0){ continue; }
+			begin_visit(r);
+			while(!call_stack.empty()){
+				const auto v = call_stack.back();
+				if(cursors[v] < m_out_offsets[v + 1]){
+					const auto w = m_out_targets[cursors[v]];
+					if(!is_alive(w, color)){
+						++cursors[v];
+					}else if(rindex[w] == 0){
+						begin_visit(w);
+					}else{
+						finish_edge(v, w);
+						++cursors[v];
+					}
+					continue;
+				}
+				call_stack.pop_back();
+				if(m_marks[v] & root_mark){
+					m_marks[v] = 0;
+					while(!vertex_stack.empty() &&
+					      rindex[v] <= rindex[vertex_stack.back()])
+					{
+						assign(vertex_stack.back(), v);
+						vertex_stack.pop_back();
+					}
+					assign(v, v);
+				}else{
+					vertex_stack.push_back(v);
+				}
+				if(!call_stack.empty()){
+					const auto u = call_stack.back();
+					finish_edge(u, v);
+					++cursors[u];
+				}
+			}
+		}
+	}
+
+	// determines the SCC of a pivot and splits the rest into at most three subproblems
+	void split(task& t, std::vector<task>& children, scratch& s){
+		auto& vertices = t.vertices;
+		const auto color = t.color;
+		trim(vertices, color, s);
+		if(vertices.empty()){ return; }
+		if(vertices.size() < m_sequential_threshold){
+			solve_sequential(vertices, color, s);
+			return;
+		}
+		const auto pivot = vertices[0];
+		reach(pivot, color, forward_mark, m_out_offsets, m_out_targets, s);
+		reach(pivot, color, backward_mark, m_in_offsets, m_in_targets, s);
+		task parts[3];
+		for(const auto v : vertices){
+			const auto mark = m_marks[v];
+			m_marks[v] = 0;
+			if(mark == (forward_mark | backward_mark)){
+				assign(v, pivot);
+			}else{
+				parts[mark].vertices.push_back(v);
+			}
+		}
+		for(auto& part : parts){
+			if(part.vertices.empty()){ continue; }
+			part.color = m_num_colors.fetch_add(1, std::memory_order_relaxed);
+			for(const auto v : part.vertices){
+				m_colors[v].store(part.color, std::memory_order_relaxed);
+			}
+			children.push_back(std::move(part));
+		}
+	}
+
+	void work(){
+		scratch s;
+		std::vector<task> children;
+		std::unique_lock<std::mutex> lock(m_mutex);
+		while(true){
+			m_condition.wait(lock, [this](){
+				return !m_tasks.empty() || m_num_active == 0;
+			});
+			if(m_tasks.empty()){ break; }
+			task t = std::move(m_tasks.back());
+			m_tasks.pop_back();
+			++m_num_active;
+			lock.unlock();
+			children.clear();
+			split(t, children, s);
+			lock.lock();
+			for(auto& child : children){ m_tasks.push_back(std::move(child)); }
+			--m_num_active;
+			m_condition.notify_all();
+		}
+	}
+
+	belonging_components_t solve(size_t num_threads){
+		const auto n = m_result.size();
+		task root;
+		root.color = 0;
+		root.vertices.resize(n);
+		for(vertex_t v = 0; v < n; ++v){ root.vertices[v] = v; }
+		m_tasks.push_back(std::move(root));
+		std::vector<std::thread> workers;
+		for(size_t i = 1; i < num_threads; ++i){
+			workers.emplace_back(&scc_fw_bw_impl::work, this);
+		}
+		work();
+		for(auto& w : workers){ w.join(); }
+		return std::move(m_result);
+	}
+
+
+public:
+	template <typename EdgeType>
+	static belonging_components_t solve(
+		const adjacency_list<EdgeType>& graph,
+		size_t num_threads,
+		size_t sequential_threshold)
+	{
+		if(num_threads <= 1){
+			sequential_threshold = std::numeric_limits<size_t>::max();
+		}
+		scc_fw_bw_impl self(graph, sequential_threshold);
+		return self.solve(num_threads);
+	}
+
+};
+
+}
+
+
+/**
+ * @brief 枝刈りと前方・後方探索 (FW-BW) による並列な強連結成分分解。
+ * @param num_threads          使用するスレッド数。
+ * @param sequential_threshold 枝刈り後の頂点数がこれより少ない部分問題は Pearce の方法で処理します。
+ * @return 各頂点が属する強連結成分の代表頂点。loquat::strongly_connected_components と同じ形式です。
+ *
+ * 入次数または出次数が 0 の頂点を繰り返し取り除いた後、ピボットから前方と後方に到達可能な頂点の
+ * 共通部分を 1 つの強連結成分とし、残りの 3 つの部分を独立な部分問題とします。
+ * 部分問題は共有のタスク列を介して複数のスレッドで並列に処理されます。
+ * num_threads が 1 以下の場合はグラフ全体を Pearce の方法で処理します。
+ * グラフは CSR 形式に変換してから走査します。
+ */
+template <typename EdgeType>
+belonging_components_t strongly_connected_components_fw_bw(
+	const adjacency_list<EdgeType>& graph,
+	size_t num_threads,
+	size_t sequential_threshold = 4096)
+{
+	return detail::scc_fw_bw_impl::solve(
+		graph, num_threads, sequential_threshold);
+}
+
+template <typename EdgeType>
+belonging_components_t strongly_connected_components_fw_bw(
+	const adjacency_list<EdgeType>& graph)
+{
+	return strongly_connected_components_fw_bw(graph, hardware_concurrency());
+}
+
+}
@@ -2,6 +2,7 @@
 #include <vector>
 #include <stack>
 #include "loquat/graph/adjacency_list.hpp"
+#include "loquat/graph/euler_tour_technique.hpp"
 
 namespace loquat {
 
@@ -66,4 +67,113 @@ std::vector<size_t> tree_post_ordering(
 	return result;
 }
 
+
+/**
+ * @brief loquat::traverse_tree による走査の結果。
+ *
+ * pre_order と pre_order_vertices は互いに逆の置換で、post_order と post_order_vertices も同様です。
+ * pre_order を新しい頂点番号とすると、各部分木が連続した番号を持つ木に並べ替えられます。
+ */
+struct tree_traversal_result {
+	std::vector<vertex_t> parents;
+	std::vector<size_t> depths;
+	std::vector<size_t> subtree_sizes;
+	std::vector<size_t> pre_order;
+	std::vector<size_t> post_order;
+	std::vector<euler_tour_technique_result> euler_tour;
+	std::vector<vertex_t> pre_order_vertices;
+	std::vector<vertex_t> post_order_vertices;
+};
+
+/**
+ * @brief 1 回の深さ優先探索で根付き木の各種の情報と順序を求めます。
+ *
+ * 結果は result に書き込まれ、既に確保されている領域は再利用されます。
+ * 作業用の領域は result の中で賄うため、容量が足りていればメモリの確保は行いません。
+ * 根の親は g.size() です。順序は loquat::tree_pre_ordering, loquat::tree_post_ordering,
+ * loquat::euler_tour_technique と一致します。
+ */
+template <typename EdgeType>
+void traverse_tree(
+	vertex_t root,
+	const adjacency_list<EdgeType>& g,
+	tree_traversal_result& result)
+{
+	const auto n = g.size();
+	result.parents.assign(n, n);
+	result.depths.resize(n);
+	result.subtree_sizes.resize(n);
+	result.pre_order.resize(n);
+	result.post_order.resize(n);
+	result.euler_tour.resize(n);
+	result.pre_order_vertices.resize(n);
+	result.post_order_vertices.resize(n);
+	if(n == 0){ return; }
+	// the DFS stack grows downward from the back of post_order_vertices, which
+	// never meets the finished prefix, and euler_tour[u].out holds the index of
+	// the next edge to examine while u is on the stack
+	auto& stack = result.post_order_vertices;
+	size_t top = n, pre = 0, post = 0, tick = 0;
+	result.depths[root] = 0;
+	result.pre_order[root] = pre;
+	result.pre_order_vertices[pre++] = root;
+	result.euler_tour[root].in = tick++;
+	result.euler_tour[root].out = 0;
+	stack[--top] = root;
+	while(top < n){
+		const auto u = stack[top];
+		auto& next = result.euler_tour[u].out;
+		if(next < g[u].size()){
+			const auto v = g[u][next++].to;
+			if(v == result.parents[u]){ continue; }
+			result.parents[v] = u;
+			result.depths[v] = result.depths[u] + 1;
+			result.pre_order[v] = pre;
+			result.pre_order_vertices[pre++] = v;
+			result.euler_tour[v].in = tick++;
+			result.euler_tour[v].out = 0;
+			stack[--top] = v;
+			continue;
+		}
+		++top;
+		result.subtree_sizes[u] = pre - result.pre_order[u];
+		result.post_order[u] = post;
+		result.post_order_vertices[post++] = u;
+		next = tick++;
+	}
+}
+
+template <typename EdgeType>
+tree_traversal_result traverse_tree(
+	vertex_t root,
+	const adjacency_list<EdgeType>& g)
+{
+	tree_traversal_result result;
+	traverse_tree(root, g, result);
+	return result;
+}
+
+/**
+ * @brief 頂点 u の番号を new_ids[u] に付け替えたグラフを生成します。
+ *
+ * 辺の順序は新しい番号での始点ごとに元の順序を保ちます。
+ */
+template <typename EdgeType>
+adjacency_list<EdgeType> relabel_vertices(
+	const adjacency_list<EdgeType>& g,
+	const std::vector<size_t>& new_ids)
+{
+	const auto n = g.size();
+	adjacency_list<EdgeType> result(n);
+	for(vertex_t u = 0; u < n; ++u){
+		auto& edges = result[new_ids[u]];
+		edges.reserve(g[u].size());
+		for(const auto& e : g[u]){
+			edges.push_back(e);
+			edges.back().to = new_ids[e.to];
+		}
+	}
+	return result;
+}
+
 }
@@ -1,5 +1,7 @@
 #pragma once
 #include <stdexcept>
+#include <vector>
+#include <utility>
 
 namespace loquat {
 
@@ -16,5 +18,30 @@ public:
 
 };
 
-}
 
+class negative_cycle_error : public no_solution_error {
+
+private:
+	std::vector<size_t> m_cycle;
+
+public:
+	negative_cycle_error(const char *what, std::vector<size_t> cycle)
+		: no_solution_error(what)
+		, m_cycle(std::move(cycle))
+	{ }
+
+	negative_cycle_error(const std::string& what, std::vector<size_t> cycle)
+		: no_solution_error(what)
+		, m_cycle(std::move(cycle))
+	{ }
+
+	/**
+	 * @brief 負閉路を構成する頂点列。辺の向きに沿った順に並びます。
+	 */
+	const std::vector<size_t>& cycle() const {
+		return m_cycle;
+	}
+
+};
+
+}
@@ -0,0 +1,159 @@
+#pragma once
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <functional>
+#include <algorithm>
+#include <condition_variable>
+
+namespace loquat {
+
+/**
+ * @brief 使用できるハードウェアスレッド数。取得できない場合は 1 を返します。
+ */
+inline size_t hardware_concurrency(){
+	const auto k = std::thread::hardware_concurrency();
+	return k == 0 ? 1 : static_cast<size_t>(k);
+}
+
+/**
+ * @brief 区間 [0, n) を連続したブロックに分割して並列に処理します。
+ * @param num_threads 使用するスレッド数の上限。
+ * @param grain       1 スレッドあたりに割り当てる要素数の下限。
+ * @param func        func(t, first, last) の形で呼び出される関数。
+ *                    t はブロックの番号で、ブロックは t の昇順に区間を覆います。
+ * @return 使用したブロックの数。
+ *
+ * ブロックが 1 つしかない場合は呼び出し元のスレッドで func(0, 0, n) を実行します。
+ * func は例外を送出してはいけません。
+ */
+template <typename Func>
+size_t parallel_for_blocks(size_t num_threads, size_t n, size_t grain, Func func){
+	const size_t limit = std::max<size_t>(n / std::max<size_t>(grain, 1), 1);
+	const size_t k = std::max<size_t>(std::min(num_threads, limit), 1);
+	if(k == 1){
+		func(size_t(0), size_t(0), n);
+		return 1;
+	}
+	std::vector<std::thread> workers;
+	workers.reserve(k - 1);
+	for(size_t t = 1; t < k; ++t){
+		workers.emplace_back(func, t, n * t / k, n * (t + 1) / k);
+	}
+	func(size_t(0), size_t(0), n / k);
+	for(auto& w : workers){ w.join(); }
+	return k;
+}
+
+
+/**
+ * @brief 生成したスレッドを使い回して parallel_for_blocks と同じ処理を行うスレッドプール。
+ *
+ * num_threads - 1 個のスレッドを構築時に起動し、破棄するまで待機させておきます。
+ * 短い並列区間を何度も繰り返す場合に、区間ごとのスレッドの生成と合流を避けられます。
+ * for_blocks を複数のスレッドから同時に呼び出すことはできません。
+ */
+class thread_pool {
+
+private:
+	std::vector<std::thread> m_workers;
+	std::mutex m_mutex;
+	std::condition_variable m_start;
+	std::condition_variable m_finish;
+	std::function<void(size_t, size_t, size_t)> m_func;
+	size_t m_size;
+	size_t m_num_blocks;
+	size_t m_num_pending;
+	size_t m_generation;
+	bool m_stop;
+
+	void work(size_t t){
+		size_t generation = 0;
+		std::unique_lock<std::mutex> lock(m_mutex);
+		while(true){
+			m_start.wait(lock, [&](){
+				return m_stop || m_generation != generation;
+			});
+			if(m_stop){ break; }
+			generation = m_generation;
+			if(t >= m_num_blocks){ continue; }
+			const auto n = m_size, k = m_num_blocks;
+			lock.unlock();
+			m_func(t, n * t / k, n * (t + 1) / k);
+			lock.lock();
+			if(--m_num_pending == 0){ m_finish.notify_one(); }
+		}
+	}
+
+
+public:
+	explicit thread_pool(size_t num_threads)
+		: m_workers()
+		, m_mutex()
+		, m_start()
+		, m_finish()
+		, m_func()
+		, m_size(0)
+		, m_num_blocks(0)
+		, m_num_pending(0)
+		, m_generation(0)
+		, m_stop(false)
+	{
+		for(size_t t = 1; t < num_threads; ++t){
+			m_workers.emplace_back(&thread_pool::work, this, t);
+		}
+	}
+
+	thread_pool(const thread_pool&) = delete;
+	thread_pool& operator=(const thread_pool&) = delete;
+
+	~thread_pool(){
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_stop = true;
+		}
+		m_start.notify_all();
+		for(auto& w : m_workers){ w.join(); }
+	}
+
+
+	/**
+	 * @brief 呼び出し元のスレッドを含むスレッド数。
+	 */
+	size_t size() const {
+		return m_workers.size() + 1;
+	}
+
+	/**
+	 * @brief parallel_for_blocks(size(), n, grain, func) と同じ分割で func を呼び出します。
+	 * @return 使用したブロックの数。
+	 *
+	 * ブロック 0 は呼び出し元のスレッドで処理し、すべてのブロックの処理が終わるまで待ちます。
+	 */
+	template <typename Func>
+	size_t for_blocks(size_t n, size_t grain, Func func){
+		const size_t limit = std::max<size_t>(n / std::max<size_t>(grain, 1), 1);
+		const size_t k = std::max<size_t>(std::min(size(), limit), 1);
+		if(k == 1){
+			func(size_t(0), size_t(0), n);
+			return 1;
+		}
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_func = std::ref(func);
+			m_size = n;
+			m_num_blocks = k;
+			m_num_pending = k - 1;
+			++m_generation;
+		}
+		m_start.notify_all();
+		func(size_t(0), size_t(0), n / k);
+		std::unique_lock<std::mutex> lock(m_mutex);
+		m_finish.wait(lock, [this](){ return m_num_pending == 0; });
+		m_func = nullptr;
+		return k;
+	}
+
+};
+
+}
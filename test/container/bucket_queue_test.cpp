@@ -0,0 +1,54 @@
+#include <gtest/gtest.h>
+#include <queue>
+#include <random>
+#include "loquat/container/bucket_queue.hpp"
+
+TEST(BucketQueueTest, DefaultConstructor){
+	loquat::bucket_queue<int, int> queue;
+	EXPECT_TRUE(queue.empty());
+	EXPECT_EQ(0u, queue.size());
+	EXPECT_EQ(0u, queue.max_span());
+}
+
+TEST(BucketQueueTest, MonotonicRandom){
+	using pair_type = std::pair<int, int>;
+	std::default_random_engine engine;
+	for(const int span : { 0, 1, 7, 100 }){
+		std::uniform_int_distribution<int> type_dist(0, 2);
+		std::uniform_int_distribution<int> delta_dist(0, span);
+		loquat::bucket_queue<int, int> queue(span);
+		std::priority_queue<
+			pair_type, std::vector<pair_type>, std::greater<pair_type>> naive;
+		int last = 0;
+		for(int iter = 0; iter < 10000; ++iter){
+			if(naive.empty() || type_dist(engine) != 0){
+				const int key = last + delta_dist(engine);
+				queue.push(key, iter);
+				naive.emplace(key, iter);
+			}else{
+				const auto actual = queue.top();
+				EXPECT_EQ(naive.top().first, actual.first);
+				last = actual.first;
+				queue.pop();
+				naive.pop();
+			}
+			EXPECT_EQ(naive.size(), queue.size());
+		}
+	}
+}
+
+TEST(BucketQueueTest, Clear){
+	loquat::bucket_queue<int, int> queue(10);
+	queue.push(7, 0);
+	queue.push(9, 1);
+	EXPECT_EQ(7, queue.top().first);
+	queue.pop();
+	queue.clear();
+	EXPECT_TRUE(queue.empty());
+	queue.push(10, 2);
+	queue.push(2, 3);
+	EXPECT_EQ(2, queue.top().first);
+	EXPECT_EQ(3, queue.top().second);
+	queue.pop();
+	EXPECT_EQ(10, queue.top().first);
+}
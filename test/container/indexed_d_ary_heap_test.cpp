@@ -0,0 +1,69 @@
+#include <gtest/gtest.h>
+#include <functional>
+#include <random>
+#include <set>
+#include "loquat/container/indexed_d_ary_heap.hpp"
+
+TEST(IndexedDAryHeapTest, DefaultConstructor){
+	loquat::indexed_d_ary_heap<int> heap;
+	EXPECT_TRUE(heap.empty());
+	EXPECT_EQ(0u, heap.size());
+	EXPECT_EQ(0u, heap.capacity());
+}
+
+namespace {
+
+template <size_t D, typename Comparator>
+void random_operations_test(){
+	using pair_type = std::pair<int, size_t>;
+	std::default_random_engine engine;
+	const size_t n = 50;
+	std::uniform_int_distribution<int> type_dist(0, 2);
+	std::uniform_int_distribution<int> key_dist(-1000, 1000);
+	std::uniform_int_distribution<size_t> index_dist(0, n - 1);
+	const Comparator comparator;
+	const auto pair_comparator =
+		[comparator](const pair_type& a, const pair_type& b) -> bool {
+			if(comparator(a.first, b.first)){ return true; }
+			if(comparator(b.first, a.first)){ return false; }
+			return a.second < b.second;
+		};
+	loquat::indexed_d_ary_heap<int, D, Comparator> heap(n);
+	std::set<pair_type, decltype(pair_comparator)> naive(pair_comparator);
+	std::vector<int> keys(n);
+	std::vector<bool> contained(n);
+	for(int iter = 0; iter < 10000; ++iter){
+		const int type = type_dist(engine);
+		if(type != 0 || naive.empty()){
+			const size_t i = index_dist(engine);
+			const int key = key_dist(engine);
+			if(contained[i]){ naive.erase(pair_type(keys[i], i)); }
+			heap.push(key, i);
+			naive.emplace(key, i);
+			keys[i] = key;
+			contained[i] = true;
+		}else{
+			const auto top = heap.top();
+			EXPECT_EQ(naive.begin()->first, top.first);
+			naive.erase(pair_type(top.first, top.second));
+			contained[top.second] = false;
+			heap.pop();
+		}
+		EXPECT_EQ(naive.size(), heap.size());
+		for(size_t i = 0; i < n; ++i){
+			EXPECT_EQ(contained[i], heap.contains(i));
+			if(contained[i]){ EXPECT_EQ(keys[i], heap.key(i)); }
+		}
+	}
+	heap.clear();
+	EXPECT_TRUE(heap.empty());
+	for(size_t i = 0; i < n; ++i){ EXPECT_FALSE(heap.contains(i)); }
+}
+
+}
+
+TEST(IndexedDAryHeapTest, RandomOperations){
+	random_operations_test<2, std::less<int>>();
+	random_operations_test<4, std::less<int>>();
+	random_operations_test<5, std::greater<int>>();
+}
@@ -0,0 +1,74 @@
+#include <gtest/gtest.h>
+#include <queue>
+#include <random>
+#include <cstdint>
+#include "loquat/container/radix_heap.hpp"
+
+TEST(RadixHeapTest, DefaultConstructor){
+	loquat::radix_heap<int, int> heap;
+	EXPECT_TRUE(heap.empty());
+	EXPECT_EQ(0u, heap.size());
+}
+
+TEST(RadixHeapTest, MonotonicRandom){
+	using pair_type = std::pair<uint64_t, int>;
+	std::default_random_engine engine;
+	std::uniform_int_distribution<int> type_dist(0, 2);
+	std::uniform_int_distribution<uint64_t> delta_dist(0, 1000000000000ull);
+	loquat::radix_heap<uint64_t, int> heap;
+	std::priority_queue<
+		pair_type, std::vector<pair_type>, std::greater<pair_type>> naive;
+	uint64_t last = 0;
+	for(int iter = 0; iter < 10000; ++iter){
+		if(naive.empty() || type_dist(engine) != 0){
+			const uint64_t key = last + delta_dist(engine);
+			heap.push(key, iter);
+			naive.emplace(key, iter);
+		}else{
+			const auto actual = heap.top();
+			EXPECT_EQ(naive.top().first, actual.first);
+			last = actual.first;
+			heap.pop();
+			naive.pop();
+		}
+		EXPECT_EQ(naive.size(), heap.size());
+	}
+}
+
+TEST(RadixHeapTest, SmallSignedKey){
+	loquat::radix_heap<int16_t, int> heap;
+	heap.push(30000, 0);
+	heap.push(5, 1);
+	heap.push(5, 2);
+	heap.push(127, 3);
+	EXPECT_EQ(5, heap.top().first);
+	heap.pop();
+	EXPECT_EQ(5, heap.top().first);
+	heap.pop();
+	heap.push(6, 4);
+	EXPECT_EQ(6, heap.top().first);
+	EXPECT_EQ(4, heap.top().second);
+	heap.pop();
+	EXPECT_EQ(127, heap.top().first);
+	heap.pop();
+	EXPECT_EQ(30000, heap.top().first);
+	heap.pop();
+	EXPECT_TRUE(heap.empty());
+}
+
+TEST(RadixHeapTest, Clear){
+	loquat::radix_heap<unsigned int, int> heap;
+	heap.push(100, 0);
+	heap.push(200, 1);
+	EXPECT_EQ(100u, heap.top().first);
+	heap.pop();
+	heap.clear();
+	EXPECT_TRUE(heap.empty());
+	// keys smaller than the last popped key are allowed again
+	heap.push(3, 2);
+	heap.push(1, 3);
+	EXPECT_EQ(1u, heap.top().first);
+	EXPECT_EQ(3, heap.top().second);
+	heap.pop();
+	EXPECT_EQ(3u, heap.top().first);
+}
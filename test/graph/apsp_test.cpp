@@ -0,0 +1,146 @@
+#include <gtest/gtest.h>
+#include <limits>
+#include <algorithm>
+#include "loquat/graph/edge.hpp"
+#include "loquat/graph/sssp_bellman_ford.hpp"
+#include "loquat/graph/apsp.hpp"
+#include "random_graph_generator.hpp"
+#include "sssp_validator.hpp"
+
+namespace {
+
+template <typename EdgeType>
+loquat::adjacency_list<EdgeType> generate_graph(
+	size_t n, double p, std::default_random_engine& engine)
+{
+	auto graph =
+		loquat::test::random_graph_generator<EdgeType>(n, p)
+			.has_self_loop(true)
+			.generate(engine);
+	loquat::test::randomize_weights(
+		graph, engine, std::uniform_int_distribution<int>(2, 100));
+	if(n >= 2){
+		std::uniform_int_distribution<loquat::vertex_t> vertex_dist(0, n - 1);
+		loquat::vertex_t u = vertex_dist(engine), v = u;
+		while(v == u){ v = vertex_dist(engine); }
+		graph.add_edge(u, v, -1);
+	}
+	return graph;
+}
+
+template <typename EdgeType>
+bool validate_apsp_result(
+	const loquat::matrix<typename EdgeType::weight_type>& actual,
+	const loquat::adjacency_list<EdgeType>& graph)
+{
+	const auto n = graph.size();
+	if(actual.rows() != n || actual.columns() != n){ return false; }
+	for(loquat::vertex_t s = 0; s < n; ++s){
+		std::vector<typename EdgeType::weight_type> row(n);
+		for(loquat::vertex_t t = 0; t < n; ++t){ row[t] = actual(s, t); }
+		if(!loquat::test::validate_sssp_result(row, s, graph)){ return false; }
+	}
+	return true;
+}
+
+}
+
+TEST(APSPTest, Johnson){
+	using edge = loquat::edge<loquat::edge_param::weight<int>>;
+	std::default_random_engine engine;
+	for(const size_t n : { 1, 2, 10, 50, 100 }){
+		const auto graph = generate_graph<edge>(n, 0.05, engine);
+		EXPECT_TRUE(validate_apsp_result(loquat::apsp_johnson(graph), graph));
+	}
+}
+
+TEST(APSPTest, JohnsonMultipleThreads){
+	using edge = loquat::edge<loquat::edge_param::weight<int>>;
+	std::default_random_engine engine;
+	for(const size_t n : { 1, 2, 10, 100 }){
+		const auto graph = generate_graph<edge>(n, 0.05, engine);
+		const auto expect = loquat::apsp_johnson(graph, 1);
+		EXPECT_TRUE(validate_apsp_result(expect, graph));
+		for(const size_t num_threads : { 2, 3, 8 }){
+			EXPECT_EQ(expect, loquat::apsp_johnson(graph, num_threads));
+		}
+	}
+	auto graph = generate_graph<edge>(30, 0.1, engine);
+	graph.add_edge(3, 4, -5);
+	graph.add_edge(4, 5, 1);
+	graph.add_edge(5, 3, 2);
+	EXPECT_THROW(loquat::apsp_johnson(graph, 4), loquat::negative_cycle_error);
+}
+
+TEST(APSPTest, FloydWarshall){
+	using edge = loquat::edge<loquat::edge_param::weight<int>>;
+	std::default_random_engine engine;
+	for(const size_t n : { 1, 2, 10, 50, 100, 150 }){
+		const auto graph = generate_graph<edge>(n, 0.3, engine);
+		EXPECT_TRUE(validate_apsp_result(
+			loquat::apsp_floyd_warshall(graph), graph));
+		EXPECT_TRUE(validate_apsp_result(loquat::apsp(graph), graph));
+	}
+}
+
+TEST(APSPTest, FloydWarshallBlockSize){
+	using edge = loquat::edge<loquat::edge_param::weight<double>>;
+	std::default_random_engine engine;
+	const size_t n = 40;
+	auto graph =
+		loquat::test::random_graph_generator<edge>(n, 0.2).generate(engine);
+	loquat::test::randomize_weights(
+		graph, engine, std::uniform_int_distribution<int>(1, 50));
+	const auto expect = loquat::apsp_johnson(graph);
+	for(const size_t block_size : { 0, 1, 3, 7, 64 }){
+		loquat::matrix<double> d(
+			n, n, loquat::positive_infinity<double>());
+		for(loquat::vertex_t u = 0; u < n; ++u){
+			d(u, u) = 0.0;
+			for(const auto& e : graph[u]){ d(u, e.to) = e.weight; }
+		}
+		loquat::floyd_warshall(d, block_size);
+		EXPECT_EQ(expect, d);
+	}
+}
+
+TEST(APSPTest, NegativeCycle){
+	using edge = loquat::edge<loquat::edge_param::weight<int>>;
+	std::default_random_engine engine;
+	auto graph = generate_graph<edge>(30, 0.1, engine);
+	graph.add_edge(3, 4, -5);
+	graph.add_edge(4, 5, 1);
+	graph.add_edge(5, 3, 2);
+	EXPECT_THROW(loquat::apsp_johnson(graph), loquat::negative_cycle_error);
+	EXPECT_THROW(loquat::apsp_floyd_warshall(graph), loquat::negative_cycle_error);
+	try{
+		loquat::apsp_floyd_warshall(graph);
+	}catch(const loquat::negative_cycle_error& e){
+		const auto& cycle = e.cycle();
+		ASSERT_FALSE(cycle.empty());
+		int sum = 0;
+		for(size_t i = 0; i < cycle.size(); ++i){
+			const auto u = cycle[i], v = cycle[(i + 1) % cycle.size()];
+			int w = std::numeric_limits<int>::max();
+			for(const auto& f : graph[u]){
+				if(f.to == v){ w = std::min(w, f.weight); }
+			}
+			ASSERT_NE(std::numeric_limits<int>::max(), w);
+			sum += w;
+		}
+		EXPECT_LT(sum, 0);
+	}
+}
+
+TEST(APSPTest, NegativeCycleLargeWeight){
+	// a cycle of large negative weights must be detected before distances overflow
+	const int big = std::numeric_limits<int>::max() / 4;
+	loquat::matrix<int> d(
+		100, 100, loquat::positive_infinity<int>());
+	for(size_t i = 0; i < 100; ++i){
+		d(i, i) = 0;
+		if(i + 1 < 100){ d(i, i + 1) = 0; }
+	}
+	d(0, 1) = d(1, 2) = d(2, 0) = -big;
+	EXPECT_THROW(loquat::floyd_warshall(d, 8), loquat::negative_cycle_error);
+}
@@ -0,0 +1,46 @@
+#include <gtest/gtest.h>
+#include <random>
+#include <numeric>
+#include <limits>
+#include <algorithm>
+#include "loquat/graph/assignment_hungarian.hpp"
+
+TEST(AssignmentHungarianTest, BruteForce){
+	std::default_random_engine engine;
+	std::uniform_int_distribution<int> c_dist(-100, 100);
+	for(size_t n = 0; n <= 6; ++n){
+		for(size_t m = n; m <= 7; ++m){
+			loquat::matrix<int> costs(n, m);
+			for(size_t i = 0; i < n; ++i){
+				for(size_t j = 0; j < m; ++j){ costs(i, j) = c_dist(engine); }
+			}
+			const auto actual = loquat::assignment_hungarian(costs);
+			std::vector<size_t> perm(m);
+			std::iota(perm.begin(), perm.end(), 0);
+			int expect = std::numeric_limits<int>::max();
+			do {
+				int sum = 0;
+				for(size_t i = 0; i < n; ++i){ sum += costs(i, perm[i]); }
+				expect = std::min(expect, sum);
+			} while(std::next_permutation(perm.begin(), perm.end()));
+			EXPECT_EQ(expect, actual.cost);
+			ASSERT_EQ(n, actual.assignment.size());
+			std::vector<bool> used(m);
+			int sum = 0;
+			for(size_t i = 0; i < n; ++i){
+				const auto j = actual.assignment[i];
+				ASSERT_LT(j, m);
+				EXPECT_FALSE(used[j]);
+				used[j] = true;
+				sum += costs(i, j);
+			}
+			EXPECT_EQ(expect, sum);
+		}
+	}
+}
+
+TEST(AssignmentHungarianTest, TooManyRows){
+	const loquat::matrix<int> costs(3, 2);
+	EXPECT_THROW(
+		loquat::assignment_hungarian(costs), loquat::no_solution_error);
+}
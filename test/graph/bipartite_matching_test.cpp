@@ -0,0 +1,74 @@
+#include <gtest/gtest.h>
+#include <random>
+#include <algorithm>
+#include "loquat/graph/edge.hpp"
+#include "loquat/graph/residual_network.hpp"
+#include "loquat/graph/maxflow_dinitz.hpp"
+#include "loquat/graph/bipartite_matching.hpp"
+
+TEST(BipartiteMatchingTest, HopcroftKarp){
+	using edge = loquat::edge<loquat::edge_param::capacity<int>>;
+	std::default_random_engine engine;
+	for(const size_t n : { 0, 1, 10, 50, 200 }){
+		for(const size_t m : { 1, 10, 50, 200 }){
+			for(const double p : { 0.01, 0.05, 0.3 }){
+				std::uniform_real_distribution<> e_dist(0.0, 1.0);
+				std::vector<std::pair<loquat::vertex_t, loquat::vertex_t>> edges;
+				for(loquat::vertex_t u = 0; u < n; ++u){
+					for(loquat::vertex_t v = 0; v < m; ++v){
+						if(e_dist(engine) < p){ edges.emplace_back(u, v); }
+					}
+				}
+				std::shuffle(edges.begin(), edges.end(), engine);
+				const loquat::bipartite_graph graph(n, m, edges);
+				EXPECT_EQ(edges.size(), graph.num_edges());
+				const auto actual =
+					loquat::bipartite_matching_hopcroft_karp(graph);
+
+				// reduction to the maximum flow problem
+				const loquat::vertex_t source = n + m, sink = n + m + 1;
+				loquat::adjacency_list<edge> network(n + m + 2);
+				for(loquat::vertex_t u = 0; u < n; ++u){
+					network.add_edge(source, u, 1);
+				}
+				for(loquat::vertex_t v = 0; v < m; ++v){
+					network.add_edge(n + v, sink, 1);
+				}
+				for(const auto& e : edges){
+					network.add_edge(e.first, n + e.second, 1);
+				}
+				auto residual = loquat::make_residual(network);
+				const auto expect = loquat::maxflow_dinitz(source, sink, residual);
+				EXPECT_EQ(static_cast<size_t>(expect), actual.size);
+
+				size_t count = 0;
+				for(loquat::vertex_t u = 0; u < n; ++u){
+					const auto v = actual.left_to_right[u];
+					if(v == m){ continue; }
+					++count;
+					EXPECT_EQ(u, actual.right_to_left[v]);
+					const auto first = graph.neighbors_begin(u);
+					const auto last = graph.neighbors_end(u);
+					EXPECT_NE(last, std::find(first, last, v));
+				}
+				EXPECT_EQ(actual.size, count);
+			}
+		}
+	}
+}
+
+TEST(BipartiteMatchingTest, FromAdjacencyList){
+	using edge = loquat::edge<>;
+	loquat::adjacency_list<edge> graph(3);
+	graph.add_edge(0, 0);
+	graph.add_edge(0, 1);
+	graph.add_edge(1, 0);
+	graph.add_edge(2, 0);
+	const loquat::bipartite_graph bipartite(graph, 2);
+	EXPECT_EQ(3u, bipartite.num_left());
+	EXPECT_EQ(2u, bipartite.num_right());
+	EXPECT_EQ(2u, bipartite.degree(0));
+	const auto actual = loquat::bipartite_matching_hopcroft_karp(bipartite);
+	EXPECT_EQ(2u, actual.size);
+	EXPECT_EQ(1u, actual.left_to_right[0]);
+}
@@ -0,0 +1,193 @@
+#include <gtest/gtest.h>
+#include <random>
+#include <algorithm>
+#include "loquat/graph/edge.hpp"
+#include "loquat/graph/adjacency_list.hpp"
+#include "loquat/graph/centroid_decomposition.hpp"
+#include "random_graph_generator.hpp"
+
+namespace {
+
+using edge = loquat::edge<>;
+
+loquat::adjacency_list<edge> make_tree(
+	int shape, size_t n, std::default_random_engine& engine)
+{
+	if(shape == 0){
+		return loquat::test::random_tree_generator<edge>(n).generate(engine);
+	}
+	loquat::adjacency_list<edge> graph(n);
+	for(loquat::vertex_t v = 1; v < n; ++v){
+		// 1: path, 2: star
+		const loquat::vertex_t u = (shape == 1 ? v - 1 : 0);
+		graph.add_edge(u, v);
+		graph.add_edge(v, u);
+	}
+	return graph;
+}
+
+std::vector<std::vector<size_t>> all_pairs_distances(
+	const loquat::adjacency_list<edge>& graph)
+{
+	const auto n = graph.size();
+	std::vector<std::vector<size_t>> result(n, std::vector<size_t>(n, n));
+	for(loquat::vertex_t s = 0; s < n; ++s){
+		std::vector<loquat::vertex_t> queue(1, s);
+		result[s][s] = 0;
+		for(size_t head = 0; head < queue.size(); ++head){
+			const auto u = queue[head];
+			for(const auto& e : graph[u]){
+				if(result[s][e.to] != n){ continue; }
+				result[s][e.to] = result[s][u] + 1;
+				queue.push_back(e.to);
+			}
+		}
+	}
+	return result;
+}
+
+// counts pairs of distinct vertices whose distance is at most k
+class path_counter {
+
+private:
+	size_t m_limit;
+	long long m_count;
+	std::vector<size_t> m_buffer;
+
+	template <typename Iterator>
+	long long count_pairs(Iterator first, Iterator last){
+		m_buffer.clear();
+		for(auto it = first; it != last; ++it){ m_buffer.push_back(it->distance); }
+		std::sort(m_buffer.begin(), m_buffer.end());
+		long long result = 0;
+		size_t j = m_buffer.size();
+		for(size_t i = 0; i < m_buffer.size(); ++i){
+			while(j > 0 && m_buffer[i] + m_buffer[j - 1] > m_limit){ --j; }
+			if(j <= i){ break; }
+			result += static_cast<long long>(j - i - 1);
+		}
+		return result;
+	}
+
+public:
+	explicit path_counter(size_t limit)
+		: m_limit(limit)
+		, m_count(0)
+		, m_buffer()
+	{ }
+
+	long long count() const { return m_count; }
+
+	template <typename Iterator>
+	void visit_component(loquat::vertex_t, Iterator first, Iterator last){
+		m_count += count_pairs(first, last);
+	}
+
+	template <typename Iterator>
+	void visit_branch(loquat::vertex_t, Iterator first, Iterator last){
+		m_count -= count_pairs(first, last);
+	}
+
+};
+
+}
+
+TEST(CentroidDecompositionTest, Structure){
+	std::default_random_engine engine;
+	for(int shape = 0; shape < 3; ++shape){
+		for(const size_t n : { 1, 2, 10, 100, 257 }){
+			const auto graph = make_tree(shape, n, engine);
+			const auto dist = all_pairs_distances(graph);
+			const loquat::centroid_decomposition cd(graph);
+			ASSERT_EQ(n, cd.size());
+			EXPECT_EQ(0u, cd.level(cd.root()));
+			EXPECT_EQ(n, cd.parent(cd.root()));
+			size_t max_level = 0;
+			for(loquat::vertex_t c = 0; c < n; ++c){
+				max_level = std::max(max_level, cd.level(c));
+				const auto first = cd.component_begin(c), last = cd.component_end(c);
+				const auto component_size = static_cast<size_t>(last - first);
+				ASSERT_EQ(c, first->vertex);
+				if(cd.parent(c) != n){
+					const auto p = cd.parent(c);
+					EXPECT_EQ(cd.level(p) + 1, cd.level(c));
+					const auto parent_size = static_cast<size_t>(
+						cd.component_end(p) - cd.component_begin(p));
+					EXPECT_LE(component_size * 2, parent_size);
+				}
+				size_t branch_total = 1;
+				for(size_t i = 0; i < cd.count_branches(c); ++i){
+					auto it = cd.branch_begin(c, i);
+					const auto end = cd.branch_end(c, i);
+					ASSERT_LT(it, end);
+					branch_total += end - it;
+					for(size_t prev = 0; it != end; ++it){
+						EXPECT_LE(prev, it->distance);
+						prev = it->distance;
+					}
+				}
+				EXPECT_EQ(component_size, branch_total);
+				for(auto it = first; it != last; ++it){
+					const auto v = it->vertex;
+					EXPECT_EQ(dist[c][v], it->distance);
+					EXPECT_EQ(dist[c][v], cd.distance(v, cd.level(c)));
+					EXPECT_LE(cd.level(c), cd.level(v));
+				}
+			}
+			size_t log_n = 0;
+			while((size_t(1) << log_n) < n){ ++log_n; }
+			EXPECT_LE(max_level, log_n);
+		}
+	}
+}
+
+TEST(CentroidDecompositionTest, CountPaths){
+	std::default_random_engine engine;
+	for(int shape = 0; shape < 3; ++shape){
+		const size_t n = 120;
+		const auto graph = make_tree(shape, n, engine);
+		const auto dist = all_pairs_distances(graph);
+		const loquat::centroid_decomposition cd(graph);
+		for(const size_t k : { 0, 1, 2, 5, 20, 200 }){
+			long long expect = 0;
+			for(loquat::vertex_t u = 0; u < n; ++u){
+				for(loquat::vertex_t v = u + 1; v < n; ++v){
+					if(dist[u][v] <= k){ ++expect; }
+				}
+			}
+			path_counter counter(k);
+			cd.traverse(counter);
+			EXPECT_EQ(expect, counter.count());
+		}
+	}
+}
+
+TEST(CentroidDecompositionTest, NearestMarkedVertex){
+	std::default_random_engine engine;
+	for(int shape = 0; shape < 3; ++shape){
+		const size_t n = 150;
+		const auto graph = make_tree(shape, n, engine);
+		const auto dist = all_pairs_distances(graph);
+		const loquat::centroid_decomposition cd(graph);
+		std::vector<size_t> best(n, n);
+		std::vector<loquat::vertex_t> marked;
+		std::uniform_int_distribution<loquat::vertex_t> vertex_dist(0, n - 1);
+		for(int iter = 0; iter < 300; ++iter){
+			const auto v = vertex_dist(engine);
+			if(iter % 3 == 0){
+				marked.push_back(v);
+				for(auto c = v; c != n; c = cd.parent(c)){
+					best[c] = std::min(best[c], cd.distance(v, cd.level(c)));
+				}
+			}else{
+				size_t expect = n;
+				for(const auto u : marked){ expect = std::min(expect, dist[u][v]); }
+				size_t actual = n;
+				for(auto c = v; c != n; c = cd.parent(c)){
+					actual = std::min(actual, best[c] + cd.distance(v, cd.level(c)));
+				}
+				EXPECT_EQ(expect, std::min(actual, n));
+			}
+		}
+	}
+}
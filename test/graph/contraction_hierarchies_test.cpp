@@ -0,0 +1,123 @@
+#include <gtest/gtest.h>
+#include "loquat/graph/edge.hpp"
+#include "loquat/graph/sssp_dijkstra.hpp"
+#include "loquat/graph/contraction_hierarchies.hpp"
+#include "random_graph_generator.hpp"
+
+namespace {
+
+template <typename EdgeType>
+bool validate_path(
+	const loquat::shortest_path_result<typename EdgeType::weight_type>& result,
+	loquat::vertex_t source,
+	loquat::vertex_t target,
+	const loquat::adjacency_list<EdgeType>& graph)
+{
+	using weight_type = typename EdgeType::weight_type;
+	if(result.path.empty()){ return false; }
+	if(result.path.front() != source){ return false; }
+	if(result.path.back() != target){ return false; }
+	weight_type sum = 0;
+	for(size_t i = 0; i + 1 < result.path.size(); ++i){
+		const auto u = result.path[i], v = result.path[i + 1];
+		auto w = loquat::positive_infinity<weight_type>();
+		for(const auto& e : graph[u]){
+			if(e.to == v){ w = std::min(w, e.weight); }
+		}
+		if(loquat::is_positive_infinity(w)){ return false; }
+		sum += w;
+	}
+	return sum == result.distance;
+}
+
+}
+
+TEST(ContractionHierarchiesTest, RandomGraph){
+	using edge = loquat::edge<loquat::edge_param::weight<int>>;
+	std::default_random_engine engine;
+	for(const size_t n : { 1, 2, 10, 50, 100 }){
+		auto graph =
+			loquat::test::random_graph_generator<edge>(n, 0.05)
+				.has_self_loop(true)
+				.generate(engine);
+		loquat::test::randomize_weights(
+			graph, engine, std::uniform_int_distribution<int>(0, 100));
+		for(const size_t limit : { 1, 500 }){
+			auto ch = loquat::make_contraction_hierarchies(graph, limit);
+			EXPECT_EQ(n, ch.size());
+			for(loquat::vertex_t s = 0; s < n; ++s){
+				const auto expect = loquat::sssp_dijkstra(s, graph);
+				for(loquat::vertex_t t = 0; t < n; ++t){
+					EXPECT_EQ(expect[t], ch.query(s, t));
+					const auto path = ch.shortest_path(s, t);
+					EXPECT_EQ(expect[t], path.distance);
+					if(loquat::is_positive_infinity(expect[t])){
+						EXPECT_TRUE(path.path.empty());
+					}else{
+						EXPECT_TRUE(validate_path(path, s, t, graph));
+					}
+				}
+			}
+		}
+	}
+}
+
+TEST(ContractionHierarchiesTest, Grid){
+	using edge = loquat::edge<loquat::edge_param::weight<double>>;
+	std::default_random_engine engine;
+	const size_t h = 15, w = 20;
+	std::uniform_int_distribution<int> weight_dist(1, 20);
+	loquat::adjacency_list<edge> graph(h * w);
+	for(size_t i = 0; i < h; ++i){
+		for(size_t j = 0; j < w; ++j){
+			const loquat::vertex_t u = i * w + j;
+			if(i + 1 < h){
+				graph.add_edge(u, u + w, weight_dist(engine));
+				graph.add_edge(u + w, u, weight_dist(engine));
+			}
+			if(j + 1 < w){
+				graph.add_edge(u, u + 1, weight_dist(engine));
+				graph.add_edge(u + 1, u, weight_dist(engine));
+			}
+		}
+	}
+	loquat::contraction_hierarchies<double> ch(graph);
+	std::uniform_int_distribution<loquat::vertex_t> vertex_dist(0, h * w - 1);
+	for(int iter = 0; iter < 20; ++iter){
+		const auto s = vertex_dist(engine);
+		const auto expect = loquat::sssp_dijkstra(s, graph);
+		for(loquat::vertex_t t = 0; t < h * w; ++t){
+			const auto path = ch.shortest_path(s, t);
+			EXPECT_EQ(expect[t], path.distance);
+			EXPECT_TRUE(validate_path(path, s, t, graph));
+		}
+	}
+}
+
+TEST(ContractionHierarchiesTest, ParallelContraction){
+	using edge = loquat::edge<loquat::edge_param::weight<int>>;
+	std::default_random_engine engine;
+	for(const size_t n : { 1, 2, 10, 100, 300 }){
+		auto graph =
+			loquat::test::random_graph_generator<edge>(n, 0.03)
+				.generate(engine);
+		loquat::test::randomize_weights(
+			graph, engine, std::uniform_int_distribution<int>(0, 100));
+		auto ch2 = loquat::make_contraction_hierarchies(graph, 500, 2);
+		auto ch4 = loquat::make_contraction_hierarchies(graph, 500, 4);
+		for(loquat::vertex_t v = 0; v < n; ++v){
+			EXPECT_EQ(ch2.rank(v), ch4.rank(v));
+		}
+		EXPECT_EQ(ch2.num_arcs(), ch4.num_arcs());
+		for(loquat::vertex_t s = 0; s < n; s += 3){
+			const auto expect = loquat::sssp_dijkstra(s, graph);
+			for(loquat::vertex_t t = 0; t < n; ++t){
+				const auto path = ch4.shortest_path(s, t);
+				EXPECT_EQ(expect[t], path.distance);
+				if(!loquat::is_positive_infinity(expect[t])){
+					EXPECT_TRUE(validate_path(path, s, t, graph));
+				}
+			}
+		}
+	}
+}
@@ -0,0 +1,137 @@
+#include <gtest/gtest.h>
+#include <random>
+#include <set>
+#include <algorithm>
+#include "loquat/graph/edge.hpp"
+#include "loquat/graph/adjacency_list.hpp"
+#include "loquat/graph/euler_tour_tree.hpp"
+#include "random_graph_generator.hpp"
+
+namespace {
+
+struct sum_behavior {
+	using value_type = int;
+	value_type identity() const { return 0; }
+	value_type merge(value_type a, value_type b) const { return a + b; }
+};
+
+class naive_forest {
+
+private:
+	std::vector<std::set<loquat::vertex_t>> m_adjacency;
+
+public:
+	explicit naive_forest(size_t n)
+		: m_adjacency(n)
+	{ }
+
+	// vertices reachable from s without passing through the edge (s, excluded)
+	std::vector<loquat::vertex_t> component(
+		loquat::vertex_t s, loquat::vertex_t excluded) const
+	{
+		const auto n = m_adjacency.size();
+		std::vector<bool> visited(n, false);
+		std::vector<loquat::vertex_t> queue(1, s);
+		visited[s] = true;
+		for(size_t head = 0; head < queue.size(); ++head){
+			const auto u = queue[head];
+			for(const auto v : m_adjacency[u]){
+				if(visited[v] || (u == s && v == excluded)){ continue; }
+				visited[v] = true;
+				queue.push_back(v);
+			}
+		}
+		return queue;
+	}
+
+	bool has_edge(loquat::vertex_t u, loquat::vertex_t v) const {
+		return m_adjacency[u].count(v) != 0;
+	}
+
+	bool connected(loquat::vertex_t u, loquat::vertex_t v) const {
+		const auto c = component(u, m_adjacency.size());
+		return std::find(c.begin(), c.end(), v) != c.end();
+	}
+
+	bool link(loquat::vertex_t u, loquat::vertex_t v){
+		if(connected(u, v)){ return false; }
+		m_adjacency[u].insert(v);
+		m_adjacency[v].insert(u);
+		return true;
+	}
+
+	bool cut(loquat::vertex_t u, loquat::vertex_t v){
+		if(!has_edge(u, v)){ return false; }
+		m_adjacency[u].erase(v);
+		m_adjacency[v].erase(u);
+		return true;
+	}
+
+};
+
+}
+
+TEST(EulerTourTreeTest, Random){
+	std::default_random_engine engine;
+	for(const size_t n : { 1, 2, 10, 50 }){
+		std::uniform_int_distribution<loquat::vertex_t> vertex_dist(0, n - 1);
+		std::uniform_int_distribution<int> type_dist(0, 6);
+		std::uniform_int_distribution<int> value_dist(-100, 100);
+		naive_forest expect(n);
+		std::vector<int> values(n);
+		for(auto& x : values){ x = value_dist(engine); }
+		loquat::euler_tour_tree<sum_behavior> actual(values.begin(), values.end());
+		ASSERT_EQ(n, actual.size());
+		for(int iter = 0; iter < 3000; ++iter){
+			const auto u = vertex_dist(engine), v = vertex_dist(engine);
+			const auto type = type_dist(engine);
+			if(type <= 1){
+				EXPECT_EQ(expect.link(u, v), actual.link(u, v));
+			}else if(type == 2){
+				EXPECT_EQ(expect.cut(u, v), actual.cut(u, v));
+			}else if(type == 3){
+				values[u] = value_dist(engine);
+				actual.update(u, values[u]);
+				EXPECT_EQ(values[u], actual.get(u));
+			}else if(type == 4){
+				actual.evert(v);
+				EXPECT_EQ(expect.connected(u, v), actual.connected(u, v));
+			}else if(type == 5){
+				const auto c = expect.component(u, n);
+				int sum = 0;
+				for(const auto w : c){ sum += values[w]; }
+				EXPECT_EQ(c.size(), actual.tree_size(u));
+				EXPECT_EQ(sum, actual.query_tree(u));
+			}else{
+				if(!expect.has_edge(u, v)){
+					EXPECT_THROW(actual.query_subtree(u, v), loquat::no_solution_error);
+					continue;
+				}
+				int sum = 0;
+				for(const auto w : expect.component(u, v)){ sum += values[w]; }
+				EXPECT_EQ(sum, actual.query_subtree(u, v));
+			}
+		}
+	}
+}
+
+TEST(EulerTourTreeTest, FromForest){
+	using edge = loquat::edge<>;
+	std::default_random_engine engine;
+	const size_t n = 100;
+	const auto tree = loquat::test::random_tree_generator<edge>(n).generate(engine);
+	loquat::euler_tour_tree<sum_behavior> ett(tree);
+	for(loquat::vertex_t v = 0; v < n; ++v){ ett.update(v, 1); }
+	EXPECT_EQ(n, ett.tree_size(0));
+	EXPECT_EQ(static_cast<int>(n), ett.query_tree(n - 1));
+	// cutting every edge leaves isolated vertices
+	for(loquat::vertex_t u = 0; u < n; ++u){
+		for(const auto& e : tree[u]){
+			if(u < e.to){ EXPECT_TRUE(ett.cut(u, e.to)); }
+		}
+	}
+	for(loquat::vertex_t v = 0; v < n; ++v){
+		EXPECT_EQ(1u, ett.tree_size(v));
+		EXPECT_FALSE(ett.connected(v, (v + 1) % n));
+	}
+}
@@ -0,0 +1,87 @@
+#include <gtest/gtest.h>
+#include <limits>
+#include <algorithm>
+#include "loquat/graph/edge.hpp"
+#include "loquat/graph/residual_network.hpp"
+#include "loquat/graph/maxflow_dinitz.hpp"
+#include "loquat/graph/gomory_hu_tree.hpp"
+#include "random_graph_generator.hpp"
+
+namespace {
+
+template <typename EdgeType>
+loquat::adjacency_list<EdgeType> random_undirected_graph(
+	size_t n, double p, std::default_random_engine& engine)
+{
+	std::uniform_real_distribution<> e_dist(0.0, 1.0);
+	std::uniform_int_distribution<int> c_dist(1, 100);
+	loquat::adjacency_list<EdgeType> graph(n);
+	for(loquat::vertex_t u = 0; u < n; ++u){
+		for(loquat::vertex_t v = u + 1; v < n; ++v){
+			if(e_dist(engine) >= p){ continue; }
+			const auto c = c_dist(engine);
+			graph.add_edge(u, v, c);
+			graph.add_edge(v, u, c);
+		}
+	}
+	return graph;
+}
+
+}
+
+TEST(GomoryHuTreeTest, AllPairsMinCut){
+	using edge = loquat::edge<loquat::edge_param::capacity<int>>;
+	std::default_random_engine engine;
+	for(const size_t n : { 1, 2, 10, 30 }){
+		for(const double p : { 0.1, 0.3 }){
+			const auto graph = random_undirected_graph<edge>(n, p, engine);
+			const auto tree = loquat::gomory_hu_tree(graph);
+			ASSERT_EQ(n, tree.size());
+			size_t num_edges = 0;
+			for(loquat::vertex_t u = 0; u < n; ++u){
+				num_edges += tree[u].size();
+			}
+			EXPECT_EQ(2 * (n - 1), num_edges);
+			for(loquat::vertex_t s = 0; s < n; ++s){
+				// minimum weight on the tree path from s to every vertex
+				std::vector<int> bottleneck(n, -1);
+				std::vector<loquat::vertex_t> stack(1, s);
+				bottleneck[s] = std::numeric_limits<int>::max();
+				while(!stack.empty()){
+					const auto u = stack.back();
+					stack.pop_back();
+					for(const auto& e : tree[u]){
+						if(bottleneck[e.to] >= 0){ continue; }
+						bottleneck[e.to] = std::min(bottleneck[u], e.weight);
+						stack.push_back(e.to);
+					}
+				}
+				for(loquat::vertex_t t = s + 1; t < n; ++t){
+					auto residual = loquat::make_residual(graph);
+					EXPECT_EQ(
+						loquat::maxflow_dinitz(s, t, residual), bottleneck[t]);
+				}
+			}
+		}
+	}
+}
+
+TEST(GomoryHuTreeTest, MultipleThreads){
+	using edge = loquat::edge<loquat::edge_param::capacity<int>>;
+	std::default_random_engine engine;
+	for(const size_t n : { 1, 2, 10, 60 }){
+		const auto graph = random_undirected_graph<edge>(n, 0.2, engine);
+		const auto expect = loquat::gomory_hu_tree(graph, 1);
+		for(const size_t num_threads : { 2, 3, 8 }){
+			const auto actual = loquat::gomory_hu_tree(graph, num_threads);
+			ASSERT_EQ(n, actual.size());
+			for(loquat::vertex_t u = 0; u < n; ++u){
+				ASSERT_EQ(expect[u].size(), actual[u].size());
+				for(size_t i = 0; i < expect[u].size(); ++i){
+					EXPECT_EQ(expect[u][i].to, actual[u][i].to);
+					EXPECT_EQ(expect[u][i].weight, actual[u][i].weight);
+				}
+			}
+		}
+	}
+}
@@ -1,6 +1,9 @@
 #include <gtest/gtest.h>
+#include <limits>
+#include <algorithm>
 #include "loquat/graph/edge.hpp"
 #include "loquat/graph/adjacency_list.hpp"
+#include "loquat/graph/breadth_first_search.hpp"
 #include "loquat/graph/heavy_light_decomposition.hpp"
 #include "loquat/container/segment_tree.hpp"
 #include "loquat/container/lazy_segment_tree.hpp"
@@ -79,6 +82,97 @@ TEST(HeavyLightDecompositionTest, RandomDecompositionHeight){
 }
 
 
+TEST(HeavyLightDecompositionTest, DeepPath){
+	const size_t n = 200000;
+	loquat::adjacency_list<edge> graph(n);
+	for(loquat::vertex_t v = 0; v + 1 < n; ++v){
+		graph.add_edge(v, v + 1);
+		graph.add_edge(v + 1, v);
+	}
+	const loquat::heavy_light_decomposition decomp(graph, 0);
+	ASSERT_EQ(1u, decomp.count_heavy_paths());
+	EXPECT_EQ(n, decomp.path_length(0));
+	EXPECT_EQ(n - 1, decomp.local_index(n - 1));
+	const auto segments = decomp.shortest_path(n - 1, 0);
+	ASSERT_EQ(1u, segments.size());
+	EXPECT_EQ(n - 1, segments[0].first);
+	EXPECT_EQ(0u, segments[0].last);
+}
+
+TEST(HeavyLightDecompositionTest, FlatDecomposition){
+	std::default_random_engine engine;
+	for(const size_t n : { 2, 10, 30, 64 }){
+		const auto graph = loquat::test::random_tree_generator<edge>(n)
+			.generate(engine);
+		const size_t height_limit =
+			loquat::bitmanip::ctz(loquat::bitmanip::clp2(n));
+		const loquat::vertex_t root = n / 2;
+		const loquat::flat_heavy_light_decomposition decomp(graph, root);
+		ASSERT_EQ(n, decomp.size());
+		for(loquat::vertex_t v = 0; v < n; ++v){
+			ASSERT_EQ(v, decomp.vertex(decomp.position(v)));
+			const auto h = decomp.head(v);
+			EXPECT_EQ(
+				decomp.position(v) - decomp.position(h),
+				decomp.depth(v) - decomp.depth(h));
+			// every vertex in the range of a subtree is a descendant
+			const auto lo = decomp.position(v);
+			const auto hi = lo + decomp.subtree_size(v);
+			for(size_t i = lo; i < hi; ++i){
+				auto u = decomp.vertex(i);
+				while(u != v && u != root){ u = decomp.parent(u); }
+				EXPECT_EQ(v, u);
+			}
+		}
+		for(loquat::vertex_t s = 0; s < n; ++s){
+			for(loquat::vertex_t t = 0; t < n; ++t){
+				std::vector<loquat::vertex_t> up, down;
+				size_t count = 0;
+				decomp.for_each_segment(s, t,
+					[&](size_t lo, size_t hi, bool upward){
+						++count;
+						if(upward){
+							for(size_t i = hi; i > lo; --i){
+								up.push_back(decomp.vertex(i - 1));
+							}
+						}else{
+							for(size_t i = hi; i > lo; --i){
+								down.push_back(decomp.vertex(i - 1));
+							}
+						}
+					});
+				up.insert(up.end(), down.rbegin(), down.rend());
+				EXPECT_LE(count, height_limit * 2);
+				EXPECT_EQ(naive_shortest_path(s, t, graph), up);
+			}
+		}
+	}
+}
+
+TEST(HeavyLightDecompositionTest, FlatDecompositionMultipleThreads){
+	std::default_random_engine engine;
+	for(const size_t n : { 1, 2, 10, 100, 3000 }){
+		const auto graph = loquat::test::random_tree_generator<edge>(n)
+			.generate(engine);
+		const loquat::vertex_t root = n / 2;
+		const loquat::flat_heavy_light_decomposition expect(graph, root);
+		for(const size_t num_threads : { 2, 3, 8 }){
+			const loquat::flat_heavy_light_decomposition actual(
+				graph, root, num_threads);
+			ASSERT_EQ(n, actual.size());
+			for(loquat::vertex_t v = 0; v < n; ++v){
+				EXPECT_EQ(expect.parent(v), actual.parent(v));
+				EXPECT_EQ(expect.depth(v), actual.depth(v));
+				EXPECT_EQ(expect.subtree_size(v), actual.subtree_size(v));
+				EXPECT_EQ(expect.head(v), actual.head(v));
+				EXPECT_EQ(expect.position(v), actual.position(v));
+				EXPECT_EQ(v, actual.vertex(actual.position(v)));
+			}
+		}
+	}
+}
+
+
 namespace {
 
 struct behavior {
@@ -134,6 +228,36 @@ TEST(HeavyLightDecompositionTest, VertexPathQuery){
 }
 
 
+namespace {
+
+struct min_behavior {
+	using value_type = int;
+
+	value_type identity() const { return std::numeric_limits<int>::max(); }
+
+	value_type merge(value_type a, value_type b) const {
+		return std::min(a, b);
+	}
+};
+
+}
+
+TEST(HeavyLightDecompositionTest, VertexPathQueryPartialInitialValues){
+	// vertices not covered by the initial values start at value_type(), not identity()
+	loquat::adjacency_list<edge> graph(4);
+	for(loquat::vertex_t v = 0; v + 1 < 4; ++v){
+		graph.add_edge(v, v + 1);
+		graph.add_edge(v + 1, v);
+	}
+	const std::vector<int> values = { 5, 7 };
+	loquat::vertex_path_queryable_tree<loquat::segment_tree<min_behavior>> decomp(
+		graph, values.begin(), values.end());
+	EXPECT_EQ(5, decomp.query(0, 1));
+	EXPECT_EQ(0, decomp.query(1, 3));
+	EXPECT_EQ(0, decomp.query(2, 2));
+}
+
+
 namespace {
 
 struct modifier_t {
@@ -224,3 +348,143 @@ TEST(HeavyLightDecompositionTest, LazyVertexPathQuery){
 		}
 	}
 }
+
+
+namespace {
+
+std::vector<loquat::vertex_t> naive_parents(
+	const loquat::adjacency_list<edge>& graph, loquat::vertex_t root)
+{
+	std::vector<loquat::vertex_t> parents(graph.size(), graph.size());
+	loquat::breadth_first_search(
+		graph, root, [&parents](loquat::vertex_t u, const edge& e){
+			parents[e.to] = u;
+		});
+	return parents;
+}
+
+bool naive_is_descendant(
+	loquat::vertex_t u, loquat::vertex_t v,
+	const std::vector<loquat::vertex_t>& parents)
+{
+	while(u != v && u != parents.size()){ u = parents[u]; }
+	return u == v;
+}
+
+}
+
+TEST(HeavyLightDecompositionTest, VertexSubtreeQuery){
+	std::default_random_engine engine;
+	const size_t n = 64;
+	std::uniform_int_distribution<int> type_dist(0, 2);
+	std::uniform_int_distribution<int> init_dist(-10, 10);
+	std::uniform_int_distribution<int> delta_dist(-5, 5);
+	std::uniform_int_distribution<loquat::vertex_t> vertex_dist(0, n - 1);
+	const auto graph = loquat::test::random_tree_generator<edge>(n)
+		.generate(engine);
+	const auto parents = naive_parents(graph, 0);
+	std::vector<int> naive_values(n);
+	for(size_t i = 0; i < n; ++i){ naive_values[i] = init_dist(engine); }
+	loquat::lazy_vertex_path_queryable_tree<lazy_segment_tree> decomp(
+		graph, naive_values.begin(), naive_values.end());
+	loquat::vertex_path_queryable_tree<segment_tree> plain(graph);
+	for(loquat::vertex_t v = 0; v < n; ++v){ plain.update(v, {static_cast<int>(v)}); }
+	for(size_t iter = 0; iter < 1000; ++iter){
+		const auto s = vertex_dist(engine);
+		const auto t = vertex_dist(engine);
+		const auto type = type_dist(engine);
+		if(type == 0){
+			const modifier_t modifier = { init_dist(engine), delta_dist(engine) };
+			int cur = modifier.offset;
+			for(const auto v : naive_shortest_path(s, t, graph)){
+				naive_values[v] += cur;
+				cur += modifier.delta;
+			}
+			decomp.modify(s, t, modifier);
+		}else if(type == 1){
+			const int x = init_dist(engine);
+			for(loquat::vertex_t v = 0; v < n; ++v){
+				if(naive_is_descendant(v, s, parents)){ naive_values[v] += x; }
+			}
+			decomp.modify_subtree(s, modifier_t(x, 0));
+		}else{
+			int expect = 0;
+			std::vector<int> expect_vertices;
+			for(loquat::vertex_t v = 0; v < n; ++v){
+				if(!naive_is_descendant(v, s, parents)){ continue; }
+				expect += naive_values[v];
+				expect_vertices.push_back(static_cast<int>(v));
+			}
+			EXPECT_EQ(expect, decomp.query_subtree(s));
+			auto actual_vertices = plain.query_subtree(s);
+			std::sort(actual_vertices.begin(), actual_vertices.end());
+			EXPECT_EQ(expect_vertices, actual_vertices);
+		}
+	}
+}
+
+TEST(HeavyLightDecompositionTest, EdgePathQuery){
+	std::default_random_engine engine;
+	const size_t n = 64;
+	std::uniform_int_distribution<int> type_dist(0, 2);
+	std::uniform_int_distribution<int> init_dist(-10, 10);
+	std::uniform_int_distribution<int> delta_dist(-5, 5);
+	std::uniform_int_distribution<loquat::vertex_t> vertex_dist(0, n - 1);
+	const auto graph = loquat::test::random_tree_generator<edge>(n)
+		.generate(engine);
+	const loquat::vertex_t root = 5;
+	const auto parents = naive_parents(graph, root);
+	// the value of the edge between v and its parent is stored at v
+	std::vector<int> naive_values(n, 0);
+	loquat::edge_path_queryable_tree<segment_tree> plain(graph, root);
+	loquat::lazy_edge_path_queryable_tree<lazy_segment_tree> decomp(graph, root);
+	for(loquat::vertex_t v = 0; v < n; ++v){
+		if(v == root){ continue; }
+		plain.update(parents[v], v, {static_cast<int>(v)});
+	}
+	const auto path_edges = [&](loquat::vertex_t s, loquat::vertex_t t){
+		const auto path = naive_shortest_path(s, t, graph);
+		std::vector<loquat::vertex_t> result;
+		for(size_t i = 0; i + 1 < path.size(); ++i){
+			const auto a = path[i], b = path[i + 1];
+			result.push_back(parents[a] == b ? a : b);
+		}
+		return result;
+	};
+	for(size_t iter = 0; iter < 1000; ++iter){
+		const auto s = vertex_dist(engine);
+		const auto t = vertex_dist(engine);
+		const auto type = type_dist(engine);
+		if(type == 0){
+			const modifier_t modifier = { init_dist(engine), delta_dist(engine) };
+			int cur = modifier.offset;
+			for(const auto v : path_edges(s, t)){
+				naive_values[v] += cur;
+				cur += modifier.delta;
+			}
+			decomp.modify(s, t, modifier);
+		}else if(type == 1){
+			const int x = init_dist(engine);
+			for(loquat::vertex_t v = 0; v < n; ++v){
+				if(v != s && naive_is_descendant(v, s, parents)){ naive_values[v] += x; }
+			}
+			decomp.modify_subtree(s, modifier_t(x, 0));
+		}else{
+			int expect = 0;
+			std::vector<int> expect_edges;
+			for(const auto v : path_edges(s, t)){
+				expect += naive_values[v];
+				expect_edges.push_back(static_cast<int>(v));
+			}
+			EXPECT_EQ(expect, decomp.query(s, t));
+			EXPECT_EQ(expect_edges, plain.query(s, t));
+			int expect_subtree = 0;
+			for(loquat::vertex_t v = 0; v < n; ++v){
+				if(v != s && naive_is_descendant(v, s, parents)){
+					expect_subtree += naive_values[v];
+				}
+			}
+			EXPECT_EQ(expect_subtree, decomp.query_subtree(s));
+		}
+	}
+}
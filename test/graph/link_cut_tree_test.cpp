@@ -0,0 +1,227 @@
+#include <gtest/gtest.h>
+#include <random>
+#include <set>
+#include <algorithm>
+#include "loquat/graph/link_cut_tree.hpp"
+
+namespace {
+
+class naive_forest {
+
+private:
+	std::vector<std::set<loquat::vertex_t>> m_adjacency;
+
+public:
+	explicit naive_forest(size_t n)
+		: m_adjacency(n)
+	{ }
+
+	// returns the path from s to t, or an empty vector if not connected
+	std::vector<loquat::vertex_t> path(loquat::vertex_t s, loquat::vertex_t t) const {
+		const auto n = m_adjacency.size();
+		std::vector<loquat::vertex_t> prev(n, n);
+		std::vector<loquat::vertex_t> queue(1, s);
+		prev[s] = s;
+		for(size_t head = 0; head < queue.size(); ++head){
+			const auto u = queue[head];
+			for(const auto v : m_adjacency[u]){
+				if(prev[v] != n){ continue; }
+				prev[v] = u;
+				queue.push_back(v);
+			}
+		}
+		if(prev[t] == n){ return {}; }
+		std::vector<loquat::vertex_t> result(1, t);
+		while(result.back() != s){ result.push_back(prev[result.back()]); }
+		std::reverse(result.begin(), result.end());
+		return result;
+	}
+
+	bool link(loquat::vertex_t u, loquat::vertex_t v){
+		if(!path(u, v).empty()){ return false; }
+		m_adjacency[u].insert(v);
+		m_adjacency[v].insert(u);
+		return true;
+	}
+
+	bool cut(loquat::vertex_t u, loquat::vertex_t v){
+		if(m_adjacency[u].count(v) == 0){ return false; }
+		m_adjacency[u].erase(v);
+		m_adjacency[v].erase(u);
+		return true;
+	}
+
+};
+
+struct sequence_behavior {
+	using value_type = std::vector<int>;
+
+	value_type identity() const { return {}; }
+
+	value_type merge(value_type a, const value_type& b) const {
+		for(const auto& x : b){ a.push_back(x); }
+		return a;
+	}
+
+	value_type reverse(value_type x) const {
+		std::reverse(x.begin(), x.end());
+		return x;
+	}
+};
+
+struct modifier_t {
+	int offset;
+	int delta;
+
+	modifier_t() : offset(0), delta(0) { }
+	modifier_t(int o, int d) : offset(o), delta(d) { }
+};
+
+// a weighted sum of values by position on a path and arithmetic progression additions
+struct weighted_behavior {
+	struct value_type {
+		long long sum;
+		long long weighted;
+		long long count;
+	};
+	using modifier_type = modifier_t;
+
+	value_type identity_value() const { return value_type{ 0, 0, 0 }; }
+
+	modifier_type identity_modifier() const { return modifier_type(); }
+
+	std::pair<modifier_type, modifier_type>
+	split_modifier(const modifier_type& m, size_t k) const {
+		return std::make_pair(
+			m, modifier_type(m.offset + m.delta * static_cast<int>(k), m.delta));
+	}
+
+	modifier_type merge_modifier(const modifier_type& a, const modifier_type& b) const {
+		return modifier_type(a.offset + b.offset, a.delta + b.delta);
+	}
+
+	value_type merge_value(const value_type& a, const value_type& b) const {
+		return value_type{
+			a.sum + b.sum,
+			a.weighted + b.weighted + b.sum * a.count,
+			a.count + b.count };
+	}
+
+	value_type modify(size_t n, const value_type& v, const modifier_type& m) const {
+		// adds offset + delta * i to the i-th value
+		const long long k = static_cast<long long>(n);
+		const long long s1 = k * (k - 1) / 2;
+		const long long s2 = (k - 1) * k * (2 * k - 1) / 6;
+		return value_type{
+			v.sum + k * m.offset + s1 * m.delta,
+			v.weighted + s1 * m.offset + s2 * m.delta,
+			v.count };
+	}
+
+	value_type reverse_value(size_t, const value_type& v) const {
+		return value_type{ v.sum, (v.count - 1) * v.sum - v.weighted, v.count };
+	}
+
+	modifier_type reverse_modifier(size_t n, const modifier_type& m) const {
+		return modifier_type(m.offset + m.delta * static_cast<int>(n - 1), -m.delta);
+	}
+};
+
+}
+
+TEST(LinkCutTreeTest, RandomPathQuery){
+	std::default_random_engine engine;
+	for(const size_t n : { 1, 2, 10, 50 }){
+		std::uniform_int_distribution<loquat::vertex_t> vertex_dist(0, n - 1);
+		std::uniform_int_distribution<int> type_dist(0, 5);
+		std::uniform_int_distribution<int> value_dist(-100, 100);
+		naive_forest expect(n);
+		std::vector<std::vector<int>> values(n);
+		for(loquat::vertex_t v = 0; v < n; ++v){ values[v].push_back(value_dist(engine)); }
+		loquat::link_cut_tree<sequence_behavior> actual(values.begin(), values.end());
+		ASSERT_EQ(n, actual.size());
+		for(int iter = 0; iter < 3000; ++iter){
+			const auto u = vertex_dist(engine), v = vertex_dist(engine);
+			const auto type = type_dist(engine);
+			if(type <= 1){
+				EXPECT_EQ(expect.link(u, v), actual.link(u, v));
+			}else if(type == 2){
+				EXPECT_EQ(expect.cut(u, v), actual.cut(u, v));
+			}else if(type == 3){
+				const int x = value_dist(engine);
+				values[u][0] = x;
+				actual.update(u, { x });
+				EXPECT_EQ(values[u], actual.get(u));
+			}else if(type == 4){
+				// lowest common ancestor after changing the root to a random vertex
+				const auto r = vertex_dist(engine);
+				const auto pu = expect.path(r, u), pv = expect.path(r, v);
+				actual.evert(r);
+				if(expect.path(u, v).empty()){
+					EXPECT_EQ(n, actual.lowest_common_ancestor(u, v));
+					continue;
+				}
+				if(pu.empty()){ continue; }
+				size_t k = 0;
+				while(k + 1 < pu.size() && k + 1 < pv.size() && pu[k + 1] == pv[k + 1]){ ++k; }
+				EXPECT_EQ(pu[k], actual.lowest_common_ancestor(u, v));
+				EXPECT_EQ(r, actual.root(u));
+			}else{
+				const auto path = expect.path(u, v);
+				EXPECT_EQ(!path.empty(), actual.connected(u, v));
+				if(path.empty()){
+					EXPECT_THROW(actual.query(u, v), loquat::no_solution_error);
+					continue;
+				}
+				std::vector<int> expect_values;
+				for(const auto w : path){ expect_values.push_back(values[w][0]); }
+				EXPECT_EQ(expect_values, actual.query(u, v));
+			}
+		}
+	}
+}
+
+TEST(LinkCutTreeTest, RandomPathModify){
+	std::default_random_engine engine;
+	const size_t n = 40;
+	std::uniform_int_distribution<loquat::vertex_t> vertex_dist(0, n - 1);
+	std::uniform_int_distribution<int> type_dist(0, 5);
+	std::uniform_int_distribution<int> value_dist(-10, 10);
+	naive_forest expect(n);
+	std::vector<long long> values(n);
+	std::vector<weighted_behavior::value_type> initial;
+	for(loquat::vertex_t v = 0; v < n; ++v){
+		values[v] = value_dist(engine);
+		initial.push_back(weighted_behavior::value_type{ values[v], 0, 1 });
+	}
+	loquat::lazy_link_cut_tree<weighted_behavior> actual(initial.begin(), initial.end());
+	for(int iter = 0; iter < 5000; ++iter){
+		const auto u = vertex_dist(engine), v = vertex_dist(engine);
+		const auto type = type_dist(engine);
+		if(type <= 1){
+			EXPECT_EQ(expect.link(u, v), actual.link(u, v));
+		}else if(type == 2){
+			EXPECT_EQ(expect.cut(u, v), actual.cut(u, v));
+		}else if(type == 3){
+			const auto path = expect.path(u, v);
+			if(path.empty()){ continue; }
+			const modifier_t m(value_dist(engine), value_dist(engine));
+			for(size_t i = 0; i < path.size(); ++i){
+				values[path[i]] += m.offset + m.delta * static_cast<long long>(i);
+			}
+			actual.modify(u, v, m);
+		}else{
+			const auto path = expect.path(u, v);
+			if(path.empty()){ continue; }
+			long long sum = 0, weighted = 0;
+			for(size_t i = 0; i < path.size(); ++i){
+				sum += values[path[i]];
+				weighted += values[path[i]] * static_cast<long long>(i);
+			}
+			const auto result = actual.query(u, v);
+			EXPECT_EQ(sum, result.sum);
+			EXPECT_EQ(weighted, result.weighted);
+			EXPECT_EQ(static_cast<long long>(path.size()), result.count);
+		}
+	}
+}
@@ -1,9 +1,14 @@
 #include <gtest/gtest.h>
 #include <unordered_set>
+#include <numeric>
+#include <algorithm>
 #include "loquat/graph/edge.hpp"
 #include "loquat/graph/adjacency_list.hpp"
 #include "loquat/graph/breadth_first_search.hpp"
 #include "loquat/graph/lowest_common_ancestor.hpp"
+#include "loquat/graph/lowest_common_ancestor_rmq.hpp"
+#include "loquat/graph/lowest_common_ancestor_offline.hpp"
+#include "loquat/graph/level_ancestor.hpp"
 #include "random_graph_generator.hpp"
 
 TEST(LowestCommonAncestorTest, Random){
@@ -41,3 +46,138 @@ TEST(LowestCommonAncestorTest, Random){
 		}
 	}
 }
+
+namespace {
+
+template <typename EdgeType>
+loquat::adjacency_list<EdgeType> random_caterpillar(
+	size_t n, std::default_random_engine& engine)
+{
+	// a long path with short branches to make the tree deep
+	std::vector<loquat::vertex_t> renamer(n);
+	std::iota(renamer.begin(), renamer.end(), 0);
+	std::shuffle(renamer.begin(), renamer.end(), engine);
+	std::uniform_int_distribution<int> branch_dist(0, 3);
+	loquat::adjacency_list<EdgeType> graph(n);
+	loquat::vertex_t spine = 0;
+	for(loquat::vertex_t v = 1; v < n; ++v){
+		const auto p = (branch_dist(engine) == 0) ? v - 1 : spine;
+		if(p == spine){ spine = v; }
+		graph.add_edge(renamer[p], renamer[v]);
+		graph.add_edge(renamer[v], renamer[p]);
+	}
+	return graph;
+}
+
+}
+
+TEST(LowestCommonAncestorTest, RangeMinimumQuery){
+	using edge = loquat::edge<>;
+	std::default_random_engine engine;
+	for(const size_t n : { 1, 2, 10, 63, 64, 65, 100, 500 }){
+		for(int shape = 0; shape < 2; ++shape){
+			const auto graph = (shape == 0)
+				? loquat::test::random_tree_generator<edge>(n).generate(engine)
+				: random_caterpillar<edge>(n, engine);
+			const loquat::vertex_t root = n / 2;
+			const loquat::lowest_common_ancestor expect(root, graph);
+			const loquat::lowest_common_ancestor_rmq actual(root, graph);
+			ASSERT_EQ(n, actual.size());
+			for(loquat::vertex_t a = 0; a < n; ++a){
+				EXPECT_EQ(expect.depth(a), actual.depth(a));
+				for(loquat::vertex_t b = 0; b < n; ++b){
+					EXPECT_EQ(expect.query(a, b), actual.query(a, b));
+				}
+			}
+		}
+	}
+}
+
+TEST(LowestCommonAncestorTest, Offline){
+	using edge = loquat::edge<>;
+	std::default_random_engine engine;
+	for(const size_t n : { 1, 2, 10, 100, 1000 }){
+		for(int shape = 0; shape < 2; ++shape){
+			const auto graph = (shape == 0)
+				? loquat::test::random_tree_generator<edge>(n).generate(engine)
+				: random_caterpillar<edge>(n, engine);
+			const loquat::vertex_t root = 0;
+			const loquat::lowest_common_ancestor expect(root, graph);
+			std::uniform_int_distribution<loquat::vertex_t> v_dist(0, n - 1);
+			std::vector<std::pair<loquat::vertex_t, loquat::vertex_t>> queries;
+			for(size_t i = 0; i < 2 * n; ++i){
+				queries.emplace_back(v_dist(engine), v_dist(engine));
+			}
+			const auto actual =
+				loquat::lowest_common_ancestor_offline(root, graph, queries);
+			ASSERT_EQ(queries.size(), actual.size());
+			for(size_t i = 0; i < queries.size(); ++i){
+				const auto& p = queries[i];
+				EXPECT_EQ(expect.query(p.first, p.second), actual[i]);
+			}
+		}
+	}
+}
+
+TEST(LowestCommonAncestorTest, LevelAncestor){
+	using edge = loquat::edge<>;
+	std::default_random_engine engine;
+	for(const size_t n : { 1, 2, 10, 63, 64, 65, 100, 500 }){
+		for(int shape = 0; shape < 2; ++shape){
+			const auto graph = (shape == 0)
+				? loquat::test::random_tree_generator<edge>(n).generate(engine)
+				: random_caterpillar<edge>(n, engine);
+			const loquat::vertex_t root = n / 2;
+			const loquat::lowest_common_ancestor expect(root, graph);
+			const loquat::level_ancestor actual(root, graph);
+			ASSERT_EQ(n, actual.size());
+			for(loquat::vertex_t v = 0; v < n; ++v){
+				const auto d = expect.depth(v);
+				ASSERT_EQ(d, actual.depth(v));
+				for(size_t k = 0; k <= d; ++k){
+					EXPECT_EQ(expect.kth_ancestor(v, k), actual.kth_ancestor(v, k));
+					EXPECT_EQ(
+						expect.kth_ancestor(v, k),
+						actual.ancestor_at_depth(v, d - k));
+				}
+				EXPECT_THROW(actual.kth_ancestor(v, d + 1), loquat::no_solution_error);
+			}
+		}
+	}
+}
+
+TEST(LowestCommonAncestorTest, LevelAncestorMicroTrees){
+	// large enough for micro trees with several vertices
+	using edge = loquat::edge<>;
+	std::default_random_engine engine;
+	for(const size_t n : { size_t(1) << 16, size_t(1) << 20 }){
+		for(int shape = 0; shape < 3; ++shape){
+			loquat::adjacency_list<edge> graph(n);
+			for(loquat::vertex_t v = 1; v < n; ++v){
+				loquat::vertex_t p;
+				if(shape == 0){
+					p = std::uniform_int_distribution<loquat::vertex_t>(0, v - 1)(engine);
+				}else if(shape == 1){
+					p = (v - 1) / 3;
+				}else{
+					const loquat::vertex_t lo = (v > 4 ? v - 4 : 0);
+					p = std::uniform_int_distribution<loquat::vertex_t>(lo, v - 1)(engine);
+				}
+				graph.add_edge(p, v);
+				graph.add_edge(v, p);
+			}
+			const loquat::lowest_common_ancestor expect(0, graph);
+			const loquat::level_ancestor actual(0, graph);
+			std::uniform_int_distribution<loquat::vertex_t> vertex_dist(0, n - 1);
+			for(int iter = 0; iter < 20000; ++iter){
+				const auto v = vertex_dist(engine);
+				const auto d = expect.depth(v);
+				ASSERT_EQ(d, actual.depth(v));
+				const auto k = std::uniform_int_distribution<size_t>(0, d)(engine);
+				ASSERT_EQ(expect.kth_ancestor(v, k), actual.kth_ancestor(v, k));
+				const auto small = std::min<size_t>(d, iter % 6);
+				ASSERT_EQ(expect.kth_ancestor(v, small), actual.kth_ancestor(v, small));
+			}
+		}
+	}
+}
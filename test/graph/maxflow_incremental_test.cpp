@@ -0,0 +1,60 @@
+#include <gtest/gtest.h>
+#include "loquat/graph/edge.hpp"
+#include "loquat/graph/residual_network.hpp"
+#include "loquat/graph/maxflow_dinitz.hpp"
+#include "loquat/graph/maxflow_incremental.hpp"
+#include "random_graph_generator.hpp"
+#include "maxflow_validator.hpp"
+
+TEST(MaxflowIncrementalTest, RandomUpdates){
+	using edge = loquat::edge<loquat::edge_param::capacity<int>>;
+	std::default_random_engine engine;
+	std::uniform_int_distribution<int> cap_dist(0, 100);
+	for(const size_t n : { 2, 10, 50 }){
+		auto graph =
+			loquat::test::random_graph_generator<edge>(n, 0.2)
+				.has_self_loop(true)
+				.generate(engine);
+		loquat::test::randomize_capacities(graph, engine, cap_dist);
+		std::vector<std::pair<loquat::vertex_t, size_t>> edges;
+		for(loquat::vertex_t u = 0; u < n; ++u){
+			for(size_t i = 0; i < graph[u].size(); ++i){
+				edges.emplace_back(u, i);
+			}
+		}
+		if(edges.empty()){ continue; }
+		const loquat::vertex_t source = 0, sink = 1;
+		auto residual = loquat::make_residual(graph);
+		const auto initial = loquat::maxflow_dinitz(source, sink, residual);
+		loquat::incremental_maxflow<loquat::residual_edge<edge>>
+			solver(source, sink, residual, initial);
+		EXPECT_EQ(initial, solver.flow());
+		std::uniform_int_distribution<size_t> edge_dist(0, edges.size() - 1);
+		for(int iter = 0; iter < 100; ++iter){
+			const auto target = edges[edge_dist(engine)];
+			const auto c = cap_dist(engine);
+			graph[target.first][target.second].capacity = c;
+			const auto actual =
+				solver.update_capacity(target.first, target.second, c);
+			EXPECT_EQ(c, solver.capacity(target.first, target.second));
+			const auto in_residual = loquat::make_residual(graph);
+			auto expect_residual = in_residual;
+			EXPECT_EQ(
+				loquat::maxflow_dinitz(source, sink, expect_residual), actual);
+			EXPECT_TRUE(loquat::test::validate_maxflow_result(
+				actual, solver.graph(), source, sink, in_residual));
+			std::vector<int> balance(n);
+			for(const auto& p : edges){
+				const auto& e = solver.graph()[p.first][p.second];
+				const auto f = solver.graph()[e.to][e.rev].capacity;
+				balance[p.first] -= f;
+				balance[e.to] += f;
+			}
+			EXPECT_EQ(-actual, balance[source]);
+			EXPECT_EQ(actual, balance[sink]);
+			for(loquat::vertex_t v = 2; v < n; ++v){
+				EXPECT_EQ(0, balance[v]);
+			}
+		}
+	}
+}
@@ -0,0 +1,48 @@
+#include <gtest/gtest.h>
+#include "loquat/graph/edge.hpp"
+#include "loquat/graph/residual_network.hpp"
+#include "loquat/graph/maxflow_push_relabel.hpp"
+#include "loquat/graph/maxflow_dinitz.hpp"
+#include "random_graph_generator.hpp"
+#include "maxflow_validator.hpp"
+
+TEST(MaxflowPushRelabelTest, RandomFlow){
+	using edge = loquat::edge<loquat::edge_param::capacity<int>>;
+	std::default_random_engine engine;
+	for(const size_t n : { 2, 10, 50, 100, 300 }){
+		for(const double p : { 0.02, 0.1, 0.5 }){
+			auto graph =
+				loquat::test::random_graph_generator<edge>(n, p)
+					.has_self_loop(true)
+					.generate(engine);
+			loquat::test::randomize_capacities(
+				graph, engine, std::uniform_int_distribution<int>(0, 100));
+			auto in_residual = loquat::make_residual(graph);
+			auto out_residual = in_residual;
+			auto dinitz_residual = in_residual;
+			const loquat::vertex_t source = 0, sink = 1;
+			const auto actual =
+				loquat::maxflow_push_relabel(source, sink, out_residual);
+			EXPECT_TRUE(loquat::test::validate_maxflow_result(
+				actual, out_residual, source, sink, in_residual));
+			EXPECT_EQ(
+				loquat::maxflow_dinitz(source, sink, dinitz_residual), actual);
+		}
+	}
+}
+
+TEST(MaxflowPushRelabelTest, ReturnsExcessToSource){
+	using edge = loquat::edge<loquat::edge_param::capacity<int>>;
+	loquat::adjacency_list<edge> graph(4);
+	graph.add_edge(0, 2, 10);
+	graph.add_edge(2, 3, 10);
+	graph.add_edge(3, 1, 3);
+	auto residual = loquat::make_residual(graph);
+	EXPECT_EQ(3, loquat::maxflow_push_relabel(0, 1, residual));
+	for(const auto& e : residual[0]){
+		if(e.to == 2){ EXPECT_EQ(7, e.capacity); }
+	}
+	for(const auto& e : residual[2]){
+		if(e.to == 3){ EXPECT_EQ(7, e.capacity); }
+	}
+}
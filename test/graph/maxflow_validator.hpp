@@ -1,4 +1,6 @@
 #pragma once
+#include <vector>
+#include <queue>
 #include "loquat/graph/adjacency_list.hpp"
 
 namespace loquat {
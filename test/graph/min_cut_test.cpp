@@ -0,0 +1,34 @@
+#include <gtest/gtest.h>
+#include "loquat/graph/edge.hpp"
+#include "loquat/graph/residual_network.hpp"
+#include "loquat/graph/maxflow_dinitz.hpp"
+#include "loquat/graph/min_cut.hpp"
+#include "random_graph_generator.hpp"
+
+TEST(MinCutTest, RandomFlow){
+	using edge = loquat::edge<loquat::edge_param::capacity<int>>;
+	std::default_random_engine engine;
+	for(const size_t n : { 2, 10, 50, 100 }){
+		auto graph =
+			loquat::test::random_graph_generator<edge>(n, 0.1)
+				.has_self_loop(true)
+				.generate(engine);
+		loquat::test::randomize_capacities(
+			graph, engine, std::uniform_int_distribution<int>(0, 100));
+		auto residual = loquat::make_residual(graph);
+		const loquat::vertex_t source = 0, sink = 1;
+		const auto flow = loquat::maxflow_dinitz(source, sink, residual);
+		const auto cut = loquat::min_cut(source, residual, graph);
+		EXPECT_EQ(flow, cut.capacity);
+		EXPECT_TRUE(cut.source_side[source]);
+		EXPECT_FALSE(cut.source_side[sink]);
+		int sum = 0;
+		for(const auto& p : cut.edges){
+			const auto& e = graph[p.first][p.second];
+			EXPECT_TRUE(cut.source_side[p.first]);
+			EXPECT_FALSE(cut.source_side[e.to]);
+			sum += e.capacity;
+		}
+		EXPECT_EQ(flow, sum);
+	}
+}
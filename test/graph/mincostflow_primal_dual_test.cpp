@@ -1,4 +1,6 @@
 #include <gtest/gtest.h>
+#include <cstdlib>
+#include <algorithm>
 #include "loquat/graph/edge.hpp"
 #include "loquat/graph/residual_network.hpp"
 #include "loquat/graph/maxflow_dinitz.hpp"
@@ -63,3 +65,108 @@ TEST(MincostflowPrimalDualTest, RandomFlow){
 	}
 }
 
+
+TEST(MincostflowPrimalDualTest, IncrementalSolver){
+	using edge = loquat::edge<
+		loquat::edge_param::weight<int>,
+		loquat::edge_param::capacity<int>>;
+	std::default_random_engine engine;
+	for(const size_t n : { 2, 10, 50 }){
+		for(const bool acyclic : { false, true }){
+			auto graph =
+				loquat::test::random_graph_generator<edge>(n, 0.2)
+					.has_self_loop(!acyclic)
+					.generate(engine);
+			loquat::test::randomize_weights(
+				graph, engine, std::uniform_int_distribution<int>(-20, 100));
+			loquat::test::randomize_capacities(
+				graph, engine, std::uniform_int_distribution<int>(0, 30));
+			if(acyclic){
+				// keep only edges from smaller to larger vertices
+				loquat::adjacency_list<edge> dag(n);
+				for(loquat::vertex_t u = 0; u < n; ++u){
+					for(const auto& e : graph[u]){
+						if(u < e.to){ dag.add_edge(u, e); }
+					}
+				}
+				graph = dag;
+			}else{
+				for(loquat::vertex_t u = 0; u < n; ++u){
+					for(auto& e : graph[u]){ e.weight = std::abs(e.weight); }
+				}
+			}
+			const auto in_residual = loquat::make_residual(graph);
+			const loquat::vertex_t source = 0, sink = n - 1;
+			const auto limit = compute_flow_limit(source, sink, in_residual);
+
+			auto residual = in_residual;
+			loquat::mincostflow_primal_dual_solver<
+				loquat::residual_edge<edge>> solver(source, sink, residual);
+			std::uniform_int_distribution<int> step_dist(0, 7);
+			while(solver.flow() < limit){
+				const auto step = step_dist(engine);
+				const auto expect_flow = std::min(limit, solver.flow() + step);
+				const auto before = solver.flow();
+				EXPECT_EQ(expect_flow - before, solver.augment(step));
+				auto expect_residual = in_residual;
+				EXPECT_EQ(
+					loquat::mincostflow_primal_dual(
+						expect_flow, source, sink, expect_residual),
+					solver.cost());
+			}
+			EXPECT_EQ(0, solver.augment(1));
+
+			const auto& points = solver.breakpoints();
+			ASSERT_FALSE(points.empty());
+			EXPECT_EQ(0, points.front().first);
+			EXPECT_EQ(limit, points.back().first);
+			for(size_t i = 1; i < points.size(); ++i){
+				const auto& a = points[i - 1];
+				const auto& b = points[i];
+				ASSERT_LT(a.first, b.first);
+				if(i >= 2){
+					// slopes of adjacent segments differ
+					const auto& z = points[i - 2];
+					EXPECT_LT(
+						(a.second - z.second) * (b.first - a.first),
+						(b.second - a.second) * (a.first - z.first));
+				}
+				for(int f = a.first; f <= b.first; ++f){
+					auto expect_residual = in_residual;
+					const auto expect = loquat::mincostflow_primal_dual(
+						f, source, sink, expect_residual);
+					EXPECT_EQ(
+						expect * (b.first - a.first),
+						a.second * (b.first - f) + b.second * (f - a.first));
+				}
+			}
+		}
+	}
+}
+
+TEST(MincostflowPrimalDualTest, BreakpointsWithLargeCosts){
+	using edge = loquat::edge<
+		loquat::edge_param::weight<long long>,
+		loquat::edge_param::capacity<int>>;
+	const long long big = 1000000000000ll;
+	const int c = 1000000;
+	loquat::adjacency_list<edge> graph(4);
+	graph.add_edge(0, 1, big, c);
+	graph.add_edge(1, 3, 0, c);
+	graph.add_edge(0, 2, 0, c);
+	graph.add_edge(2, 3, big, c);
+	graph.add_edge(0, 3, 3 * big, c);
+	auto residual = loquat::make_residual(graph);
+	loquat::mincostflow_primal_dual_solver<
+		loquat::residual_edge<edge>> solver(0, 3, residual);
+	EXPECT_EQ(c, solver.augment(c));
+	EXPECT_EQ(2 * c, solver.augment(2 * c));
+	EXPECT_EQ(3 * c, solver.flow());
+	const auto& points = solver.breakpoints();
+	ASSERT_EQ(3u, points.size());
+	EXPECT_EQ(0, points[0].first);
+	EXPECT_EQ(2 * c, points[1].first);
+	EXPECT_EQ(2 * c * big, points[1].second);
+	EXPECT_EQ(3 * c, points[2].first);
+	EXPECT_EQ(5 * c * big, points[2].second);
+}
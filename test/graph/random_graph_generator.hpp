@@ -1,4 +1,6 @@
 #pragma once
+#include <algorithm>
+#include <numeric>
 #include <functional>
 #include <random>
 #include "loquat/graph/adjacency_list.hpp"
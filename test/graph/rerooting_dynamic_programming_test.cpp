@@ -0,0 +1,187 @@
+#include <gtest/gtest.h>
+#include <random>
+#include <algorithm>
+#include <utility>
+#include "loquat/graph/edge.hpp"
+#include "loquat/graph/adjacency_list.hpp"
+#include "loquat/graph/rerooting_dynamic_programming.hpp"
+#include "random_graph_generator.hpp"
+
+namespace {
+
+using edge = loquat::edge<>;
+
+// a random forest made of a few random trees with shuffled vertex ids
+loquat::adjacency_list<edge> random_forest(
+	size_t n, std::default_random_engine& engine)
+{
+	std::vector<loquat::vertex_t> renamer(n);
+	for(loquat::vertex_t v = 0; v < n; ++v){ renamer[v] = v; }
+	std::shuffle(renamer.begin(), renamer.end(), engine);
+	loquat::adjacency_list<edge> forest(n);
+	std::uniform_int_distribution<size_t> size_dist(1, std::max<size_t>(1, n / 3));
+	size_t offset = 0;
+	while(offset < n){
+		const auto k = std::min(size_dist(engine), n - offset);
+		const auto tree =
+			loquat::test::random_tree_generator<edge>(k).generate(engine);
+		for(loquat::vertex_t u = 0; u < k; ++u){
+			for(const auto& e : tree[u]){
+				forest.add_edge(renamer[offset + u], renamer[offset + e.to]);
+			}
+		}
+		offset += k;
+	}
+	return forest;
+}
+
+std::vector<size_t> distances_from(
+	loquat::vertex_t s, const loquat::adjacency_list<edge>& graph)
+{
+	const auto n = graph.size();
+	std::vector<size_t> result(n, n);
+	std::vector<loquat::vertex_t> queue(1, s);
+	result[s] = 0;
+	for(size_t head = 0; head < queue.size(); ++head){
+		const auto u = queue[head];
+		for(const auto& e : graph[u]){
+			if(result[e.to] != n){ continue; }
+			result[e.to] = result[u] + 1;
+			queue.push_back(e.to);
+		}
+	}
+	return result;
+}
+
+// the number of vertices and the sum of distances to them
+struct distance_sum_behavior {
+	using state_type = std::pair<size_t, size_t>;
+
+	state_type identity() const { return state_type(0, 0); }
+
+	state_type lift(const state_type& x, loquat::vertex_t, const edge&) const {
+		return state_type(x.first, x.second + x.first);
+	}
+
+	state_type combine(const state_type& a, const state_type& b) const {
+		return state_type(a.first + b.first, a.second + b.second);
+	}
+
+	state_type finalize(const state_type& acc, loquat::vertex_t) const {
+		return state_type(acc.first + 1, acc.second);
+	}
+};
+
+// the height of the tree, which cannot be purged
+struct height_behavior {
+	using state_type = size_t;
+
+	state_type identity() const { return 0; }
+
+	state_type lift(const state_type& x, loquat::vertex_t, const edge&) const {
+		return x + 1;
+	}
+
+	state_type combine(const state_type& a, const state_type& b) const {
+		return std::max(a, b);
+	}
+
+	state_type finalize(const state_type& acc, loquat::vertex_t) const {
+		return acc;
+	}
+};
+
+// counts calls of lift through the extra argument
+struct counting_behavior {
+	using state_type = size_t;
+
+	state_type identity() const { return 0; }
+
+	state_type lift(const state_type& x, loquat::vertex_t, const edge&, size_t& count) const {
+		++count;
+		return x;
+	}
+
+	state_type combine(const state_type& a, const state_type& b) const {
+		return a + b;
+	}
+
+	state_type finalize(const state_type& acc, loquat::vertex_t, size_t&) const {
+		return acc + 1;
+	}
+};
+
+}
+
+TEST(RerootingDynamicProgrammingTest, DistanceSum){
+	std::default_random_engine engine;
+	for(const size_t n : { 1, 2, 10, 100 }){
+		const auto forest = random_forest(n, engine);
+		const auto actual = loquat::rerooting_dynamic_programming(
+			forest, distance_sum_behavior());
+		ASSERT_EQ(n, actual.size());
+		for(loquat::vertex_t v = 0; v < n; ++v){
+			const auto d = distances_from(v, forest);
+			size_t count = 0, sum = 0;
+			for(const auto x : d){
+				if(x == n){ continue; }
+				++count;
+				sum += x;
+			}
+			EXPECT_EQ(count, actual[v].first);
+			EXPECT_EQ(sum, actual[v].second);
+		}
+	}
+}
+
+TEST(RerootingDynamicProgrammingTest, Eccentricity){
+	std::default_random_engine engine;
+	for(const size_t n : { 1, 2, 10, 100 }){
+		const auto forest = random_forest(n, engine);
+		const auto actual = loquat::rerooting_dynamic_programming(
+			forest, height_behavior());
+		for(loquat::vertex_t v = 0; v < n; ++v){
+			const auto d = distances_from(v, forest);
+			size_t expect = 0;
+			for(const auto x : d){
+				if(x != n){ expect = std::max(expect, x); }
+			}
+			EXPECT_EQ(expect, actual[v]);
+		}
+	}
+}
+
+TEST(RerootingDynamicProgrammingTest, LiftOncePerEdge){
+	std::default_random_engine engine;
+	for(const size_t n : { 1, 2, 10, 100 }){
+		const auto forest = random_forest(n, engine);
+		size_t num_edges = 0;
+		for(loquat::vertex_t u = 0; u < n; ++u){ num_edges += forest[u].size(); }
+		size_t count = 0;
+		const auto actual = loquat::rerooting_dynamic_programming(
+			forest, counting_behavior(), count);
+		EXPECT_EQ(num_edges, count);
+		for(loquat::vertex_t v = 0; v < n; ++v){
+			const auto d = distances_from(v, forest);
+			EXPECT_EQ(static_cast<size_t>(std::count_if(
+				d.begin(), d.end(), [n](size_t x){ return x != n; })), actual[v]);
+		}
+	}
+}
+
+TEST(RerootingDynamicProgrammingTest, MultipleThreads){
+	std::default_random_engine engine;
+	for(const size_t n : { 1, 2, 100, 5000, 20000 }){
+		const auto forest = random_forest(n, engine);
+		const auto expect_sums = loquat::rerooting_dynamic_programming(
+			forest, distance_sum_behavior());
+		const auto expect_heights = loquat::rerooting_dynamic_programming(
+			forest, height_behavior());
+		for(const size_t num_threads : { 1, 2, 4 }){
+			EXPECT_EQ(expect_sums, loquat::rerooting_dynamic_programming_parallel(
+				forest, num_threads, distance_sum_behavior()));
+			EXPECT_EQ(expect_heights, loquat::rerooting_dynamic_programming_parallel(
+				forest, num_threads, height_behavior()));
+		}
+	}
+}
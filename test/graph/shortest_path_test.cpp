@@ -0,0 +1,181 @@
+#include <gtest/gtest.h>
+#include <cstdlib>
+#include "loquat/graph/edge.hpp"
+#include "loquat/graph/sssp_dijkstra.hpp"
+#include "loquat/graph/shortest_path.hpp"
+#include "random_graph_generator.hpp"
+
+namespace {
+
+template <typename EdgeType>
+bool validate_shortest_path_result(
+	const loquat::shortest_path_result<typename EdgeType::weight_type>& result,
+	loquat::vertex_t source,
+	loquat::vertex_t target,
+	const std::vector<typename EdgeType::weight_type>& distances,
+	const loquat::adjacency_list<EdgeType>& graph)
+{
+	using weight_type = typename EdgeType::weight_type;
+	if(result.distance != distances[target]){ return false; }
+	if(loquat::is_positive_infinity(distances[target])){
+		return result.path.empty();
+	}
+	if(result.path.empty()){ return false; }
+	if(result.path.front() != source){ return false; }
+	if(result.path.back() != target){ return false; }
+	weight_type sum = 0;
+	for(size_t i = 0; i + 1 < result.path.size(); ++i){
+		const auto u = result.path[i], v = result.path[i + 1];
+		auto w = loquat::positive_infinity<weight_type>();
+		for(const auto& e : graph[u]){
+			if(e.to == v){ w = std::min(w, e.weight); }
+		}
+		if(loquat::is_positive_infinity(w)){ return false; }
+		sum += w;
+	}
+	return sum == result.distance;
+}
+
+}
+
+TEST(ShortestPathTest, Random){
+	using edge = loquat::edge<loquat::edge_param::weight<int>>;
+	std::default_random_engine engine;
+	for(const size_t n : { 2, 10, 50, 100 }){
+		auto graph =
+			loquat::test::random_graph_generator<edge>(n, 0.05)
+				.has_self_loop(true)
+				.generate(engine);
+		loquat::test::randomize_weights(
+			graph, engine, std::uniform_int_distribution<int>(0, 100));
+		const auto reversed = loquat::transpose(graph);
+		for(loquat::vertex_t s = 0; s < n; s += 3){
+			const auto expect = loquat::sssp_dijkstra(s, graph);
+			for(loquat::vertex_t t = 0; t < n; ++t){
+				EXPECT_TRUE(validate_shortest_path_result(
+					loquat::shortest_path(s, t, graph), s, t, expect, graph));
+				EXPECT_TRUE(validate_shortest_path_result(
+					loquat::shortest_path(
+						s, t, graph, loquat::sssp_queue_policy::binary_heap()),
+					s, t, expect, graph));
+				EXPECT_TRUE(validate_shortest_path_result(
+					loquat::shortest_path_bidirectional(s, t, graph, reversed),
+					s, t, expect, graph));
+			}
+		}
+	}
+}
+
+TEST(ShortestPathTest, BidirectionalFloatingWeight){
+	using edge = loquat::edge<loquat::edge_param::weight<double>>;
+	std::default_random_engine engine;
+	for(const size_t n : { 2, 10, 50, 100 }){
+		auto graph =
+			loquat::test::random_graph_generator<edge>(n, 0.05)
+				.generate(engine);
+		loquat::test::randomize_weights(
+			graph, engine, std::uniform_int_distribution<int>(1, 8));
+		for(loquat::vertex_t s = 0; s < n; s += 7){
+			const auto expect = loquat::sssp_dijkstra(s, graph);
+			for(loquat::vertex_t t = 0; t < n; ++t){
+				EXPECT_TRUE(validate_shortest_path_result(
+					loquat::shortest_path_bidirectional(s, t, graph),
+					s, t, expect, graph));
+			}
+		}
+	}
+}
+
+TEST(ShortestPathTest, AStarOnGrid){
+	using edge = loquat::edge<loquat::edge_param::weight<int>>;
+	std::default_random_engine engine;
+	const int h = 20, w = 30;
+	std::uniform_int_distribution<int> weight_dist(1, 10);
+	std::uniform_int_distribution<int> wall_dist(0, 9);
+	loquat::adjacency_list<edge> graph(h * w);
+	for(int i = 0; i < h; ++i){
+		for(int j = 0; j < w; ++j){
+			const loquat::vertex_t u = i * w + j;
+			if(i + 1 < h && wall_dist(engine) != 0){
+				graph.add_edge(u, u + w, weight_dist(engine));
+				graph.add_edge(u + w, u, weight_dist(engine));
+			}
+			if(j + 1 < w && wall_dist(engine) != 0){
+				graph.add_edge(u, u + 1, weight_dist(engine));
+				graph.add_edge(u + 1, u, weight_dist(engine));
+			}
+		}
+	}
+	std::uniform_int_distribution<loquat::vertex_t> vertex_dist(0, h * w - 1);
+	for(int iter = 0; iter < 50; ++iter){
+		const auto s = vertex_dist(engine), t = vertex_dist(engine);
+		const int ti = static_cast<int>(t) / w, tj = static_cast<int>(t) % w;
+		const auto heuristic = [w, ti, tj](loquat::vertex_t v) -> int {
+			const int vi = static_cast<int>(v) / w, vj = static_cast<int>(v) % w;
+			return std::abs(vi - ti) + std::abs(vj - tj);
+		};
+		const auto expect = loquat::sssp_dijkstra(s, graph);
+		EXPECT_TRUE(validate_shortest_path_result(
+			loquat::shortest_path_astar(s, t, graph, heuristic),
+			s, t, expect, graph));
+		// heuristic values exceed the largest edge weight
+		EXPECT_TRUE(validate_shortest_path_result(
+			loquat::shortest_path_astar(
+				s, t, graph, heuristic, loquat::sssp_queue_policy::bucket()),
+			s, t, expect, graph));
+	}
+}
+
+namespace {
+
+template <typename QueuePolicy>
+void test_reused_workspace(){
+	using edge = loquat::edge<loquat::edge_param::weight<unsigned int>>;
+	std::default_random_engine engine;
+	const size_t n = 60;
+	auto graph =
+		loquat::test::random_graph_generator<edge>(n, 0.08)
+			.generate(engine);
+	loquat::test::randomize_weights(
+		graph, engine, std::uniform_int_distribution<unsigned int>(0, 20));
+	const auto reversed = loquat::transpose(graph);
+	// half of the exact distance to t is a consistent heuristic
+	std::vector<std::vector<unsigned int>> lower_bounds(n);
+	for(loquat::vertex_t t = 0; t < n; ++t){
+		const auto d = loquat::sssp_dijkstra(t, reversed);
+		unsigned int upper = 0;
+		for(const auto x : d){
+			if(!loquat::is_positive_infinity(x)){ upper = std::max(upper, x / 2); }
+		}
+		for(const auto x : d){
+			lower_bounds[t].push_back(
+				loquat::is_positive_infinity(x) ? upper : x / 2);
+		}
+	}
+	loquat::shortest_path_workspace<unsigned int, QueuePolicy> workspace(graph);
+	for(loquat::vertex_t s = 0; s < n; s += 5){
+		const auto expect = loquat::sssp_dijkstra(s, graph);
+		for(loquat::vertex_t t = 0; t < n; ++t){
+			const auto& h = lower_bounds[t];
+			const auto heuristic = [&h](loquat::vertex_t v){ return h[v]; };
+			EXPECT_TRUE(validate_shortest_path_result(
+				loquat::shortest_path(s, t, graph, workspace),
+				s, t, expect, graph));
+			EXPECT_TRUE(validate_shortest_path_result(
+				loquat::shortest_path_astar(s, t, graph, heuristic, workspace),
+				s, t, expect, graph));
+			EXPECT_TRUE(validate_shortest_path_result(
+				loquat::shortest_path_bidirectional(s, t, graph, reversed, workspace),
+				s, t, expect, graph));
+		}
+	}
+}
+
+}
+
+TEST(ShortestPathTest, ReusedWorkspace){
+	test_reused_workspace<loquat::sssp_queue_policy::binary_heap>();
+	test_reused_workspace<loquat::sssp_queue_policy::d_ary_heap>();
+	test_reused_workspace<loquat::sssp_queue_policy::radix_heap>();
+	test_reused_workspace<loquat::sssp_queue_policy::bucket>();
+}
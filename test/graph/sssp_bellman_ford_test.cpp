@@ -70,6 +70,11 @@ TEST(SSSPBellmanFordTest, HasNegativeCycles){
 		EXPECT_THROW(
 			loquat::sssp_bellman_ford(source, graph),
 			loquat::no_solution_error);
+		try {
+			loquat::sssp_bellman_ford(source, graph);
+		}catch(const loquat::negative_cycle_error& e){
+			EXPECT_TRUE(loquat::test::validate_negative_cycle(e.cycle(), graph));
+		}
 	}
 }
 
@@ -0,0 +1,108 @@
+#include <gtest/gtest.h>
+#include "loquat/graph/edge.hpp"
+#include "loquat/graph/sssp_delta_stepping.hpp"
+#include "random_graph_generator.hpp"
+#include "sssp_validator.hpp"
+
+TEST(SSSPDeltaSteppingTest, IntegerWeight){
+	using edge = loquat::edge<loquat::edge_param::weight<int>>;
+	std::default_random_engine engine;
+	for(const size_t n : { 2, 10, 50, 100, 500 }){
+		auto graph =
+			loquat::test::random_graph_generator<edge>(n, 0.05)
+				.has_self_loop(true)
+				.generate(engine);
+		loquat::test::randomize_weights(
+			graph, engine, std::uniform_int_distribution<int>(0, 100));
+		const loquat::vertex_t source = 1;
+		const auto actual = loquat::sssp_delta_stepping(source, graph);
+		EXPECT_TRUE(loquat::test::validate_sssp_result(actual, source, graph));
+		for(const int delta : { 1, 7, 100, 1000 }){
+			const auto actual = loquat::sssp_delta_stepping(source, graph, delta);
+			EXPECT_TRUE(loquat::test::validate_sssp_result(actual, source, graph));
+		}
+	}
+}
+
+TEST(SSSPDeltaSteppingTest, FloatingWeight){
+	using edge = loquat::edge<loquat::edge_param::weight<double>>;
+	std::default_random_engine engine;
+	for(const size_t n : { 2, 10, 50, 100, 500 }){
+		auto graph =
+			loquat::test::random_graph_generator<edge>(n, 0.05)
+				.has_self_loop(true)
+				.generate(engine);
+		loquat::test::randomize_weights(
+			graph, engine, std::uniform_real_distribution<double>(0, 1.0));
+		const loquat::vertex_t source = 1;
+		const auto actual = loquat::sssp_delta_stepping(source, graph);
+		EXPECT_TRUE(loquat::test::validate_sssp_result(actual, source, graph));
+		for(const double delta : { 0.01, 0.3, 2.0 }){
+			const auto actual = loquat::sssp_delta_stepping(source, graph, delta);
+			EXPECT_TRUE(loquat::test::validate_sssp_result(actual, source, graph));
+		}
+	}
+}
+
+TEST(SSSPDeltaSteppingTest, ZeroWeight){
+	using edge = loquat::edge<loquat::edge_param::weight<int>>;
+	std::default_random_engine engine;
+	auto graph =
+		loquat::test::random_graph_generator<edge>(100, 0.05)
+			.has_self_loop(true)
+			.generate(engine);
+	const loquat::vertex_t source = 0;
+	const auto actual = loquat::sssp_delta_stepping(source, graph);
+	EXPECT_TRUE(loquat::test::validate_sssp_result(actual, source, graph));
+}
+
+TEST(SSSPDeltaSteppingTest, MultipleThreads){
+	using edge = loquat::edge<loquat::edge_param::weight<int>>;
+	std::default_random_engine engine;
+	auto graph =
+		loquat::test::random_graph_generator<edge>(3000, 0.01)
+			.generate(engine);
+	loquat::test::randomize_weights(
+		graph, engine, std::uniform_int_distribution<int>(0, 100));
+	const loquat::vertex_t source = 0;
+	for(const size_t num_threads : { 1, 2, 4 }){
+		for(const int delta : { 10, 100 }){
+			const auto actual =
+				loquat::sssp_delta_stepping(source, graph, delta, num_threads);
+			EXPECT_TRUE(loquat::test::validate_sssp_result(actual, source, graph));
+		}
+	}
+}
+
+TEST(SSSPDeltaSteppingTest, NonPositiveDelta){
+	using edge = loquat::edge<loquat::edge_param::weight<int>>;
+	loquat::adjacency_list<edge> graph(2);
+	graph.add_edge(0, 1, 3);
+	EXPECT_THROW(loquat::sssp_delta_stepping(0, graph, 0), std::invalid_argument);
+	EXPECT_THROW(loquat::sssp_delta_stepping(0, graph, -1), std::invalid_argument);
+}
+
+TEST(SSSPDeltaSteppingTest, TinyDelta){
+	std::default_random_engine engine;
+	{
+		using edge = loquat::edge<loquat::edge_param::weight<long long>>;
+		auto graph =
+			loquat::test::random_graph_generator<edge>(100, 0.05)
+				.generate(engine);
+		loquat::test::randomize_weights(
+			graph, engine,
+			std::uniform_int_distribution<long long>(0, 1000000000000ll));
+		const auto actual = loquat::sssp_delta_stepping(0, graph, 1, 2);
+		EXPECT_TRUE(loquat::test::validate_sssp_result(actual, 0, graph));
+	}
+	{
+		using edge = loquat::edge<loquat::edge_param::weight<double>>;
+		auto graph =
+			loquat::test::random_graph_generator<edge>(100, 0.05)
+				.generate(engine);
+		loquat::test::randomize_weights(
+			graph, engine, std::uniform_real_distribution<double>(0.0, 100.0));
+		const auto actual = loquat::sssp_delta_stepping(0, graph, 1e-300, 2);
+		EXPECT_TRUE(loquat::test::validate_sssp_result(actual, 0, graph));
+	}
+}
@@ -1,4 +1,5 @@
 #include <gtest/gtest.h>
+#include <type_traits>
 #include "loquat/graph/edge.hpp"
 #include "loquat/graph/sssp_dijkstra.hpp"
 #include "random_graph_generator.hpp"
@@ -36,3 +37,97 @@ TEST(SSSPDijkstraTest, FloatingWeight){
 	}
 }
 
+
+namespace {
+
+template <typename QueuePolicy>
+void integer_weight_policy_test(int max_weight){
+	using edge = loquat::edge<loquat::edge_param::weight<int>>;
+	std::default_random_engine engine;
+	for(const size_t n : { 2, 10, 50, 100, 500 }){
+		auto graph =
+			loquat::test::random_graph_generator<edge>(n, 0.05)
+				.has_self_loop(true)
+				.generate(engine);
+		loquat::test::randomize_weights(
+			graph, engine, std::uniform_int_distribution<int>(0, max_weight));
+		const loquat::vertex_t source = 1;
+		const auto actual =
+			loquat::sssp_dijkstra(source, graph, QueuePolicy());
+		EXPECT_TRUE(loquat::test::validate_sssp_result(actual, source, graph));
+	}
+}
+
+}
+
+TEST(SSSPDijkstraTest, BinaryHeapPolicy){
+	integer_weight_policy_test<loquat::sssp_queue_policy::binary_heap>(100);
+}
+
+TEST(SSSPDijkstraTest, DAryHeapPolicy){
+	integer_weight_policy_test<loquat::sssp_queue_policy::d_ary_heap>(100);
+}
+
+TEST(SSSPDijkstraTest, RadixHeapPolicy){
+	integer_weight_policy_test<loquat::sssp_queue_policy::radix_heap>(1000000);
+}
+
+TEST(SSSPDijkstraTest, BucketPolicy){
+	integer_weight_policy_test<loquat::sssp_queue_policy::bucket>(0);
+	integer_weight_policy_test<loquat::sssp_queue_policy::bucket>(10);
+}
+
+TEST(SSSPDijkstraTest, ShortestPathTree){
+	using edge = loquat::edge<loquat::edge_param::weight<int>>;
+	std::default_random_engine engine;
+	for(const size_t n : { 2, 10, 50, 100, 500 }){
+		auto graph =
+			loquat::test::random_graph_generator<edge>(n, 0.05)
+				.has_self_loop(true)
+				.generate(engine);
+		loquat::test::randomize_weights(
+			graph, engine, std::uniform_int_distribution<int>(0, 100));
+		const loquat::vertex_t source = 1;
+		const auto actual = loquat::sssp_dijkstra_tree(source, graph);
+		EXPECT_TRUE(loquat::test::validate_sssp_result(
+			actual.distances, source, graph));
+		EXPECT_EQ(n, actual.parents[source]);
+		for(loquat::vertex_t v = 0; v < n; ++v){
+			const auto path = loquat::restore_path(actual, v);
+			if(loquat::is_positive_infinity(actual.distances[v])){
+				EXPECT_TRUE(path.empty());
+				continue;
+			}
+			ASSERT_FALSE(path.empty());
+			EXPECT_EQ(source, path.front());
+			EXPECT_EQ(v, path.back());
+			int sum = 0;
+			for(size_t i = 0; i + 1 < path.size(); ++i){
+				int w = std::numeric_limits<int>::max();
+				for(const auto& e : graph[path[i]]){
+					if(e.to == path[i + 1]){ w = std::min(w, e.weight); }
+				}
+				sum += w;
+			}
+			EXPECT_EQ(actual.distances[v], sum);
+		}
+	}
+}
+
+TEST(SSSPDijkstraTest, AutomaticPolicySelection){
+	using loquat::sssp_queue_policy::automatic;
+	using loquat::sssp_queue_policy::radix_heap;
+	using loquat::sssp_queue_policy::d_ary_heap;
+	EXPECT_TRUE((std::is_same<radix_heap, automatic::policy_type<unsigned int>>::value));
+	EXPECT_TRUE((std::is_same<d_ary_heap, automatic::policy_type<int>>::value));
+	EXPECT_TRUE((std::is_same<d_ary_heap, automatic::policy_type<double>>::value));
+	// a negative edge reached late is still propagated with signed weights
+	using edge = loquat::edge<loquat::edge_param::weight<int>>;
+	loquat::adjacency_list<edge> graph(4);
+	graph.add_edge(0, 1, 1);
+	graph.add_edge(0, 2, 5);
+	graph.add_edge(2, 1, -10);
+	graph.add_edge(1, 3, 1);
+	const auto actual = loquat::sssp_dijkstra(0, graph);
+	EXPECT_EQ((std::vector<int>{ 0, -5, 5, -4 }), actual);
+}
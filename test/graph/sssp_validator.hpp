@@ -46,5 +46,29 @@ bool validate_sssp_result(
 	return true;
 }
 
+template <typename EdgeType>
+bool validate_negative_cycle(
+	const std::vector<vertex_t>& cycle,
+	const adjacency_list<EdgeType>& graph)
+{
+	using weight_type = typename EdgeType::weight_type;
+	if(cycle.empty()){ return false; }
+	const size_t m = cycle.size();
+	weight_type sum = 0;
+	for(size_t i = 0; i < m; ++i){
+		const auto u = cycle[i], v = cycle[(i + 1) % m];
+		bool found = false;
+		weight_type w = 0;
+		for(const auto& e : graph[u]){
+			if(e.to != v){ continue; }
+			if(!found || e.weight < w){ w = e.weight; }
+			found = true;
+		}
+		if(!found){ return false; }
+		sum += w;
+	}
+	return sum < 0;
+}
+
 }
 }
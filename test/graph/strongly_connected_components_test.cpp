@@ -1,6 +1,8 @@
 #include <gtest/gtest.h>
 #include <queue>
+#include <algorithm>
 #include "loquat/graph/strongly_connected_components.hpp"
+#include "loquat/graph/strongly_connected_components_fw_bw.hpp"
 #include "random_graph_generator.hpp"
 
 TEST(StronglyConnectedComponentsTest, Random){
@@ -40,3 +42,88 @@ TEST(StronglyConnectedComponentsTest, Random){
 	}
 }
 
+
+TEST(StronglyConnectedComponentsTest, Pearce){
+	using edge = loquat::edge<>;
+	std::default_random_engine engine;
+	for(const size_t n : { 1, 2, 10, 50, 60, 75, 80, 90, 100, 1000 }){
+		auto graph =
+			loquat::test::random_graph_generator<edge>(n, 2.0 / n)
+				.has_self_loop(true)
+				.generate(engine);
+		const auto expect = loquat::strongly_connected_components(graph);
+		const auto actual = loquat::strongly_connected_components_pearce(graph);
+		ASSERT_EQ(n, actual.size());
+		size_t num_components = 0;
+		for(loquat::vertex_t u = 0; u < n; ++u){
+			num_components = std::max(num_components, actual[u] + 1);
+			for(loquat::vertex_t v = 0; v < n; ++v){
+				EXPECT_EQ(expect[u] == expect[v], actual[u] == actual[v]);
+			}
+			for(const auto& e : graph[u]){
+				EXPECT_GE(actual[u], actual[e.to]);
+			}
+		}
+		std::vector<bool> used(num_components);
+		for(loquat::vertex_t u = 0; u < n; ++u){ used[actual[u]] = true; }
+		for(size_t c = 0; c < num_components; ++c){ EXPECT_TRUE(used[c]); }
+	}
+}
+
+TEST(StronglyConnectedComponentsTest, ForwardBackward){
+	using edge = loquat::edge<>;
+	std::default_random_engine engine;
+	for(const size_t n : { 1, 2, 10, 50, 60, 75, 80, 90, 100, 1000 }){
+		for(const double degree : { 1.0, 2.0, 4.0 }){
+			auto graph =
+				loquat::test::random_graph_generator<edge>(n, degree / n)
+					.has_self_loop(true)
+					.generate(engine);
+			const auto expect = loquat::strongly_connected_components(graph);
+			for(const size_t num_threads : { 1, 4 }){
+				for(const size_t threshold : { 1, 16 }){
+					const auto actual = loquat::strongly_connected_components_fw_bw(
+						graph, num_threads, threshold);
+					ASSERT_EQ(n, actual.size());
+					for(loquat::vertex_t u = 0; u < n; ++u){
+						EXPECT_EQ(actual[actual[u]], actual[u]);
+						EXPECT_EQ(expect[actual[u]], expect[u]);
+						for(loquat::vertex_t v = 0; v < n; ++v){
+							EXPECT_EQ(expect[u] == expect[v], actual[u] == actual[v]);
+						}
+					}
+				}
+			}
+		}
+	}
+}
+
+TEST(StronglyConnectedComponentsTest, ForwardBackwardLarge){
+	using edge = loquat::edge<>;
+	std::default_random_engine engine;
+	const size_t n = 30000;
+	for(const double degree : { 1.0, 1.5, 3.0 }){
+		std::uniform_int_distribution<loquat::vertex_t> vertex_dist(0, n - 1);
+		loquat::adjacency_list<edge> graph(n);
+		for(size_t i = 0; i < static_cast<size_t>(n * degree); ++i){
+			graph.add_edge(vertex_dist(engine), vertex_dist(engine));
+		}
+		const auto expect = loquat::strongly_connected_components(graph);
+		size_t expect_count = 0;
+		for(loquat::vertex_t u = 0; u < n; ++u){
+			if(expect[u] == u){ ++expect_count; }
+		}
+		for(const size_t num_threads : { 1, 2, 8 }){
+			const auto actual = loquat::strongly_connected_components_fw_bw(
+				graph, num_threads, 64);
+			ASSERT_EQ(n, actual.size());
+			size_t actual_count = 0;
+			for(loquat::vertex_t u = 0; u < n; ++u){
+				ASSERT_EQ(actual[actual[u]], actual[u]);
+				ASSERT_EQ(expect[actual[u]], expect[u]);
+				if(actual[u] == u){ ++actual_count; }
+			}
+			EXPECT_EQ(expect_count, actual_count);
+		}
+	}
+}
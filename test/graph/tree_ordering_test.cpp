@@ -58,3 +58,45 @@ TEST(TreePostOrderingTest, RandomTree){
 		}
 	}
 }
+
+TEST(TreeTraversalTest, RandomTree){
+	using edge = loquat::edge<>;
+	std::default_random_engine engine;
+	loquat::tree_traversal_result actual;
+	for(const size_t n : { 1, 2, 10, 50, 100 }){
+		const auto graph =
+			loquat::test::random_tree_generator<edge>(n)
+				.generate(engine);
+		const loquat::vertex_t root = n / 2;
+		loquat::traverse_tree(root, graph, actual);
+		const auto pre = loquat::tree_pre_ordering(root, graph);
+		const auto post = loquat::tree_post_ordering(root, graph);
+		const auto ett = loquat::euler_tour_technique(root, graph);
+		EXPECT_EQ(n, actual.parents[root]);
+		EXPECT_EQ(0u, actual.depths[root]);
+		for(loquat::vertex_t u = 0; u < n; ++u){
+			EXPECT_EQ(pre[u], actual.pre_order[u]);
+			EXPECT_EQ(post[u], actual.post_order[u]);
+			EXPECT_EQ(ett[u].in, actual.euler_tour[u].in);
+			EXPECT_EQ(ett[u].out, actual.euler_tour[u].out);
+			EXPECT_EQ(u, actual.pre_order_vertices[actual.pre_order[u]]);
+			EXPECT_EQ(u, actual.post_order_vertices[actual.post_order[u]]);
+			EXPECT_EQ((ett[u].out - ett[u].in + 1) / 2, actual.subtree_sizes[u]);
+			if(u != root){
+				const auto p = actual.parents[u];
+				EXPECT_EQ(actual.depths[p] + 1, actual.depths[u]);
+				EXPECT_LT(ett[p].in, ett[u].in);
+				EXPECT_LT(ett[u].out, ett[p].out);
+			}
+		}
+		// relabeling by pre-order gives contiguous subtrees
+		const auto relabeled = loquat::relabel_vertices(graph, actual.pre_order);
+		const auto renamed = loquat::traverse_tree(0, relabeled);
+		for(loquat::vertex_t v = 0; v < n; ++v){
+			EXPECT_EQ(v, renamed.pre_order[v]);
+			EXPECT_EQ(
+				actual.subtree_sizes[actual.pre_order_vertices[v]],
+				renamed.subtree_sizes[v]);
+		}
+	}
+}
@@ -1,4 +1,5 @@
 #include <gtest/gtest.h>
+#include <algorithm>
 #include "loquat/math/eratosthenes.hpp"
 
 namespace {
@@ -0,0 +1,47 @@
+#include <gtest/gtest.h>
+#include <vector>
+#include "loquat/misc/parallel.hpp"
+
+TEST(ParallelTest, BlocksCoverRange){
+	for(const size_t n : { 0, 1, 7, 100, 1000 }){
+		for(const size_t num_threads : { 1, 2, 3, 8 }){
+			for(const size_t grain : { 0, 1, 10, 5000 }){
+				std::vector<size_t> owners(n, num_threads);
+				std::vector<std::pair<size_t, size_t>> bounds(num_threads);
+				const auto k = loquat::parallel_for_blocks(
+					num_threads, n, grain,
+					[&](size_t t, size_t first, size_t last){
+						bounds[t] = std::make_pair(first, last);
+						for(size_t i = first; i < last; ++i){ owners[i] = t; }
+					});
+				ASSERT_GE(k, 1u);
+				ASSERT_LE(k, num_threads);
+				EXPECT_EQ(0u, bounds[0].first);
+				EXPECT_EQ(n, bounds[k - 1].second);
+				for(size_t t = 0; t + 1 < k; ++t){
+					EXPECT_EQ(bounds[t].second, bounds[t + 1].first);
+				}
+				for(size_t i = 0; i < n; ++i){
+					EXPECT_LT(owners[i], k);
+				}
+			}
+		}
+	}
+}
+
+TEST(ParallelTest, ThreadPoolReusesWorkers){
+	for(const size_t num_threads : { 1, 2, 4 }){
+		loquat::thread_pool pool(num_threads);
+		EXPECT_EQ(num_threads, pool.size());
+		for(const size_t n : { 0, 1, 7, 100, 1000, 3, 1000 }){
+			std::vector<size_t> counts(n, 0);
+			const auto k = pool.for_blocks(n, 10,
+				[&](size_t, size_t first, size_t last){
+					for(size_t i = first; i < last; ++i){ ++counts[i]; }
+				});
+			ASSERT_GE(k, 1u);
+			ASSERT_LE(k, num_threads);
+			for(size_t i = 0; i < n; ++i){ EXPECT_EQ(1u, counts[i]); }
+		}
+	}
+}